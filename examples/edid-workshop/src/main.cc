@@ -4,6 +4,7 @@
 #include <strstream>
 
 #include "edid/edid.hh"
+#include "edid/file_io.hh"
 #include "edid/json.hh"
 #include "edid/bcp00501.hh"
 
@@ -13,8 +14,8 @@
 using namespace std;
 
 Edid::EdidData read_edid_file(const string& path) {
-  auto edid_binary = Edid::read_file(path);
-  return Edid::parse_edid_binary(edid_binary);
+  const Edid::MappedFile edid_binary(path);
+  return Edid::parse_edid_binary(edid_binary.data(), edid_binary.size());
 }
 
 void print_decoded_edid(const string& path) {
@@ -27,8 +28,7 @@ void print_decoded_edid(const string& path) {
 }
 
 void print_json(const string& path_to_edid) {
-  auto edid_binary = Edid::read_file(path_to_edid);
-  nlohmann::json j = Edid::parse_edid_binary(edid_binary);
+  nlohmann::json j = read_edid_file(path_to_edid);
   cout << j.dump(2) << endl;
 }
 
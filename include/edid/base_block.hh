@@ -10,6 +10,7 @@
 
 #include "common.hh"
 #include "eighteen_byte_descriptor.hh"
+#include "parse_result.hh"
 
 #define BASE_START_MANUFACTURE_YEAR 1990
 
@@ -351,6 +352,13 @@ namespace Edid {
     uint8_t ext_blocks  /**< Number of extension blocks following the Base Block in effective EDID binary */
   );
 
+  /** Writes EDID Base Block binary to EDID_BLOCK_SIZE bytes starting at out */
+  void write_base_block(
+    const BaseBlock& base_block,  /**< Base Block structure */
+    uint8_t ext_blocks,  /**< Number of extension blocks following the Base Block in effective EDID binary */
+    uint8_t* out  /**< Destination of EDID_BLOCK_SIZE bytes */
+  );
+
   std::optional<StandardTiming> parse_standard_timing(uint8_t byte_1, uint8_t byte_2);
   std::pair<uint8_t, uint8_t> generate_standard_timing(const std::optional<StandardTiming>& std_timing);
 
@@ -359,6 +367,16 @@ namespace Edid {
     const std::array<uint8_t, EDID_BLOCK_SIZE>& base_block  /**< EDID Base Block binary */
   );
 
+  /** Finds the first error parse_base_block would throw on, without throwing or allocating */
+  std::optional<ParseError> check_base_block(
+    const uint8_t* base_block  /**< Start of EDID_BLOCK_SIZE bytes of EDID Base Block binary */
+  );
+
+  /** Parses EDID Base Block binary in place, without copying it */
+  std::pair<BaseBlock, uint8_t> parse_base_block(
+    const uint8_t* base_block  /**< Start of EDID_BLOCK_SIZE bytes of EDID Base Block binary */
+  );
+
   void print_standard_timing(
     std::ostream& os,  /**< Output stream */
     const StandardTiming& std_timing  /**< Standard Timing structure */
@@ -8,5 +8,6 @@
 
 namespace Edid {
   nlohmann::json generate_constraint_set(const VideoTimingMode& mode);
+  /** Built on every call, EdidCache keeps the result per EDID binary */
   nlohmann::json generate_constraint_sets(const EdidData& edid);
 }
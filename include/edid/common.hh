@@ -5,8 +5,12 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -18,10 +22,7 @@
 
 #define BITMASK_TRUE(length) static_cast<uint8_t>(std::pow(2.0, length) - 1)
 
-#ifdef ENABLE_JSON
-#define STRINGIFY_ENUM(ENUM_TYPE, ...)                                             \
-  NLOHMANN_JSON_SERIALIZE_ENUM(ENUM_TYPE, __VA_ARGS__)                             \
-                                                                                   \
+#define ENUM_STRING_FUNCTIONS(ENUM_TYPE, ...)                                      \
   inline std::string to_string(const ENUM_TYPE& e)                                 \
   {                                                                                \
     static_assert(std::is_enum<ENUM_TYPE>::value, #ENUM_TYPE " must be an enum!"); \
@@ -32,20 +33,30 @@
       return es_pair.first == e;                                                   \
     });                                                                            \
     return ((it != std::end(m)) ? it : std::begin(m))->second;                     \
-  }
-#else
-#define STRINGIFY_ENUM(ENUM_TYPE, ...)                                             \
-  inline std::string to_string(const ENUM_TYPE& e)                                 \
+  }                                                                                \
+                                                                                   \
+  /* Returns false if no enumerator is named s, unlike to_string() */              \
+  inline bool from_string(std::string_view s, ENUM_TYPE& e)                        \
   {                                                                                \
-    static_assert(std::is_enum<ENUM_TYPE>::value, #ENUM_TYPE " must be an enum!"); \
     static const std::pair<ENUM_TYPE, std::string> m[] = __VA_ARGS__;              \
     auto it = std::find_if(std::begin(m), std::end(m),                             \
-      [e](const std::pair<ENUM_TYPE, std::string>& es_pair) -> bool                \
+      [s](const std::pair<ENUM_TYPE, std::string>& es_pair) -> bool                \
     {                                                                              \
-      return es_pair.first == e;                                                   \
+      return es_pair.second == s;                                                  \
     });                                                                            \
-    return ((it != std::end(m)) ? it : std::begin(m))->second;                     \
+    if (it == std::end(m))                                                         \
+      return false;                                                                \
+    e = it->first;                                                                 \
+    return true;                                                                   \
   }
+
+#ifdef ENABLE_JSON
+#define STRINGIFY_ENUM(ENUM_TYPE, ...)                                             \
+  NLOHMANN_JSON_SERIALIZE_ENUM(ENUM_TYPE, __VA_ARGS__)                             \
+  ENUM_STRING_FUNCTIONS(ENUM_TYPE, __VA_ARGS__)
+#else
+#define STRINGIFY_ENUM(ENUM_TYPE, ...)                                             \
+  ENUM_STRING_FUNCTIONS(ENUM_TYPE, __VA_ARGS__)
 #endif
 
 #define TIED_OP(STRUCT, OP, GET_FIELDS)                                            \
@@ -79,18 +90,73 @@ namespace Edid {
   };
   template<class... Ts> Overload(Ts...) -> Overload<Ts...>;
 
+  /** Range over the set bits of a bitfield as enum values, from the least significant one.
+   *  Each step isolates the lowest set bit and clears it, so iteration never allocates
+   *  and costs one step per set bit only.
+   */
+  template<typename E>
+  class BitfieldEnums {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = E;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const E*;
+      using reference = E;
+
+      constexpr iterator() = default;
+      constexpr explicit iterator(uint64_t bits) : bits_(bits) {}
+
+      constexpr E operator*() const { return static_cast<E>(bits_ & (~bits_ + 1)); }
+      constexpr iterator& operator++() {
+        bits_ &= bits_ - 1;
+        return *this;
+      }
+      constexpr iterator operator++(int) {
+        iterator it = *this;
+        ++*this;
+        return it;
+      }
+      constexpr bool operator==(const iterator& other) const { return bits_ == other.bits_; }
+      constexpr bool operator!=(const iterator& other) const { return bits_ != other.bits_; }
+
+     private:
+      uint64_t bits_ = 0;
+    };
+
+    constexpr explicit BitfieldEnums(uint64_t bits) : bits_(bits) {}
+
+    constexpr iterator begin() const { return iterator(bits_); }
+    constexpr iterator end() const { return iterator(); }
+    constexpr bool empty() const { return bits_ == 0; }
+
+   private:
+    uint64_t bits_;
+  };
+
   template<typename E, typename T>
-  std::vector<E> bitfield_to_enums(T bitfield) {
+  constexpr BitfieldEnums<E> bitfield_to_enums(T bitfield) {
     static_assert(std::is_enum<E>::value,
-      "bitfield_to_enums: Template parameter T must be an enum!");
-    static_assert(std::is_arithmetic<T>::value,
-      "bitfield_to_enums: Template parameter E must be an arithmetic type!");
-    std::vector<E> result;
-    for (int i = 0; i < 8 * sizeof(T); ++i)
-      if (bitfield & (1 << i))
-        result.push_back(static_cast<E>(1 << i));
-    return result;
+      "bitfield_to_enums: Template parameter E must be an enum!");
+    static_assert(std::is_integral<T>::value,
+      "bitfield_to_enums: Template parameter T must be an integral type!");
+    return BitfieldEnums<E>(static_cast<std::make_unsigned_t<T>>(bitfield));
   }
   uint8_t calculate_block_checksum(const std::array<uint8_t, EDID_BLOCK_SIZE>& block);
-  std::vector<uint8_t> read_file(const std::string& file_path);
+  uint8_t calculate_block_checksum(const uint8_t* block);
+
+  /** Verifies checksums of consecutive EDID blocks, e.g. a whole buffer of received EDIDs.
+   *  Returns the index of the first block with invalid checksum or count if all of them are valid.
+   */
+  size_t verify_checksums(
+    const uint8_t* blocks,  /**< Start of count * EDID_BLOCK_SIZE bytes */
+    size_t count  /**< Number of blocks */
+  );
+
+  /** Rewrites invalid checksums of consecutive EDID blocks in place and returns the number of rewritten ones */
+  size_t repair_checksums(
+    uint8_t* blocks,  /**< Start of count * EDID_BLOCK_SIZE bytes */
+    size_t count  /**< Number of blocks */
+  );
 }  // namespace Edid
@@ -3,12 +3,14 @@
 
 #include <array>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <vector>
 
 #include "cta_data_block.hh"
 #include "dtd.hh"
 #include "hdmi_vendor_data_block.hh"
+#include "parse_result.hh"
 
 #define CTA861_EXT_TAG 0x02
 #define CTA861_VERSION 3
@@ -35,7 +37,7 @@ namespace Edid {
     VideoCapabilityDataBlock,         // [CTA-861-I] Section 7.5.6
     ColorimetryDataBlock              // [CTA-861-I] Section 7.5.5
   >;
-  using DataBlockCollection = std::vector<CtaDataBlock>;
+  using DataBlockCollection = std::pmr::vector<CtaDataBlock>;
 
   // See CTA-861-G Section 7.5
   struct Cta861Block {
@@ -44,7 +46,14 @@ namespace Edid {
     bool ycbcr_444 = false;
     bool ycbcr_422 = false;
     DataBlockCollection data_block_collection;
-    std::vector<DetailedTimingDescriptor> detailed_timing_descriptors;
+    std::pmr::vector<DetailedTimingDescriptor> detailed_timing_descriptors;
+
+    Cta861Block() = default;
+
+    explicit Cta861Block(std::pmr::memory_resource* resource)
+      : data_block_collection(resource)
+      , detailed_timing_descriptors(resource)
+    {}
   };
 
 #define FIELDS(X) X.underscan, X.basic_audio, X.ycbcr_444, X.ycbcr_422, \
@@ -53,10 +62,27 @@ namespace Edid {
 #undef FIELDS
 
   std::vector<uint8_t> generate_data_block_collection(const DataBlockCollection& collection);
+  /** Writes Data Block Collection binary to out and returns the end of it */
+  uint8_t* write_data_block_collection(const DataBlockCollection& collection, uint8_t* out);
   std::array<uint8_t, EDID_BLOCK_SIZE> generate_cta861_block(const Cta861Block& cta861_block);
+  /** Writes CTA-861 Extension Block binary to EDID_BLOCK_SIZE bytes starting at out */
+  void write_cta861_block(const Cta861Block& cta861_block, uint8_t* out);
 
   DataBlockCollection parse_data_block_collection(const std::vector<uint8_t>& collection);
+  /** Parses Data Block Collection in place; every container of the result allocates from resource */
+  DataBlockCollection parse_data_block_collection(
+    const uint8_t* collection,
+    size_t size,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+  );
+  /** Finds the first error parse_cta861_block would throw on, without throwing or allocating */
+  std::optional<ParseError> check_cta861_block(const uint8_t* cta861);
   Cta861Block parse_cta861_block(const std::array<uint8_t, EDID_BLOCK_SIZE>& cta861);
+  /** Parses CTA-861 Extension Block in place; every container of the result allocates from resource */
+  Cta861Block parse_cta861_block(
+    const uint8_t* cta861,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+  );
 
   void print_cta861_block(std::ostream& os, const Cta861Block& cta861_block);
 }  // namespace Edid
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <algorithm>
+#include <memory_resource>
 #include <optional>
 #include <set>
 #include <variant>
@@ -26,6 +27,10 @@
 #define CTA861_EXTENDED_YCBCR420_CAPABILITY_MAP_DATA_BLOCK_TAG  0x0F
 
 #define CTA861_SPEAKERS_DATA_BLOCK_LENGTH 3
+#define CTA861_COLORIMETRY_DATA_BLOCK_LENGTH 3
+#define CTA861_VIDEO_CAPABILITY_DATA_BLOCK_LENGTH 2
+#define CTA861_HDR_STATIC_METADATA_DATA_BLOCK_MIN_LENGTH 3
+#define CTA861_HDR_STATIC_METADATA_DATA_BLOCK_MAX_LENGTH 6
 
 namespace Edid {
   static const std::array<uint8_t, 3> hdmi_oui_little_endian = {0x03, 0x0C, 0x00};
@@ -73,18 +78,29 @@ namespace Edid {
     virtual ~ICtaDataBlock() = default;
 
     virtual CtaDataBlockType type() const = 0;
-    virtual std::vector<uint8_t> generate_byte_block() const = 0;
+    /** Writes size() bytes of Data Block binary to out and returns the end of them */
+    virtual uint8_t* write_byte_block(uint8_t* out) const = 0;
     virtual void print(std::ostream& os, uint8_t tabs = 1) const = 0;
     virtual size_t size() const = 0;
+
+    std::vector<uint8_t> generate_byte_block() const {
+      std::vector<uint8_t> result(size());
+      write_byte_block(result.data());
+      return result;
+    }
   };
 
   struct UnknownDataBlock : ICtaDataBlock {
-    std::vector<uint8_t> raw_data;
+    std::pmr::vector<uint8_t> raw_data;
     uint8_t data_block_tag;
     std::optional<uint8_t> extended_tag;
 
     UnknownDataBlock() = default;
 
+    explicit UnknownDataBlock(std::pmr::memory_resource* resource)
+      : raw_data(resource)
+    {}
+
     // for brace-enclosed initialization despite
     // inheritance from a base class with virtual funcs
     UnknownDataBlock(
@@ -92,7 +108,7 @@ namespace Edid {
       uint8_t data_block_tag,
       const std::optional<uint8_t>& extended_tag = std::nullopt
     )
-      : raw_data(raw_data)
+      : raw_data(raw_data.begin(), raw_data.end())
       , data_block_tag(data_block_tag)
       , extended_tag(extended_tag)
     {}
@@ -108,22 +124,25 @@ namespace Edid {
       return raw_data.size() + CTA861_DATA_BLOCK_HEADER_SIZE + (extended_tag.has_value() ? CTA861_EXTENDED_TAG_SIZE : 0);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
-    static UnknownDataBlock parse_byte_block(const uint8_t* start) {
-      UnknownDataBlock result;
+    static UnknownDataBlock parse_byte_block(
+      const uint8_t* start,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) {
+      UnknownDataBlock result(resource);
       int pos = 0;
 
       result.data_block_tag = *start >> 5 & BITMASK_TRUE(3);
       int data_block_size = *(start + pos++) & BITMASK_TRUE(5);
       if (result.data_block_tag == CTA861_EXTENDED_TAG) {
+        if (data_block_size < CTA861_EXTENDED_TAG_SIZE)
+          throw EdidException(__FUNCTION__, "Extended Tag Data Block has no Extended Data Block Tag");
         result.extended_tag = *(start + pos++);
         --data_block_size;
       }
-      result.raw_data = std::vector<uint8_t>(data_block_size, 0x00);
-
-      std::copy(start + pos, start + pos + data_block_size, result.raw_data.begin());
+      result.raw_data.assign(start + pos, start + pos + data_block_size);
       return result;
     }
   };
@@ -133,14 +152,18 @@ namespace Edid {
 #undef FIELDS
 
   struct VideoDataBlock : ICtaDataBlock {
-    std::vector<uint8_t> vics;
+    std::pmr::vector<uint8_t> vics;
 
     VideoDataBlock() = default;
 
+    explicit VideoDataBlock(std::pmr::memory_resource* resource)
+      : vics(resource)
+    {}
+
     VideoDataBlock(
       const std::vector<uint8_t>& vics
     )
-      : vics(vics)
+      : vics(vics.begin(), vics.end())
     {}
 
     size_t size() const override {
@@ -159,11 +182,14 @@ namespace Edid {
       return result;
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
-    static VideoDataBlock parse_byte_block(const uint8_t* start) {
-      VideoDataBlock result;
+    static VideoDataBlock parse_byte_block(
+      const uint8_t* start,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) {
+      VideoDataBlock result(resource);
 
       int data_block_tag = *start >> 5 & BITMASK_TRUE(3);
       if (data_block_tag != CTA861_VIDEO_DATA_BLOCK_TAG)
@@ -173,10 +199,7 @@ namespace Edid {
 
       const size_t vics = *start & BITMASK_TRUE(5);
 
-      if (vics > 0) {
-        result.vics.resize(vics, 0x0);
-        std::copy(start + 1, start + 1 + vics, result.vics.data());
-      }
+      result.vics.assign(start + 1, start + 1 + vics);
 
       return result;
     }
@@ -300,7 +323,13 @@ namespace Edid {
 #undef FIELDS
 
   struct AudioDataBlock : ICtaDataBlock {
-    std::vector<ShortAudioDescriptor> sads;
+    std::pmr::vector<ShortAudioDescriptor> sads;
+
+    AudioDataBlock() = default;
+
+    explicit AudioDataBlock(std::pmr::memory_resource* resource)
+      : sads(resource)
+    {}
 
     size_t size() const override {
       return sads.size() * ShortAudioDescriptor::size() + CTA861_DATA_BLOCK_HEADER_SIZE;
@@ -310,11 +339,14 @@ namespace Edid {
       return CtaDataBlockType(CTA861_AUDIO_DATA_BLOCK_TAG);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
-    static AudioDataBlock parse_byte_block(const uint8_t* start) {
-      AudioDataBlock result;
+    static AudioDataBlock parse_byte_block(
+      const uint8_t* start,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) {
+      AudioDataBlock result(resource);
       int pos = 0;
 
       int data_block_tag = *start >> 5 & BITMASK_TRUE(3);
@@ -386,7 +418,7 @@ namespace Edid {
       return CtaDataBlockType(CTA861_SPEAKERS_DATA_BLOCK_TAG);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
     static SpeakerAllocationDataBlock parse_byte_block(const uint8_t* start) {
@@ -430,7 +462,7 @@ namespace Edid {
       return CtaDataBlockType(CTA861_EXTENDED_TAG, CTA861_EXTENDED_YCBCR420_CAPABILITY_MAP_DATA_BLOCK_TAG);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
     static YCbCr420CapabilityMapDataBlock parse_byte_block(const uint8_t* start) {
@@ -443,6 +475,8 @@ namespace Edid {
         );
 
       const int length = *start++ & BITMASK_TRUE(5);
+      if (length < CTA861_EXTENDED_TAG_SIZE)
+        throw EdidException(__FUNCTION__, "Extended Tag Data Block has no Extended Data Block Tag");
 
       int extended_tag = *start++;
       if (extended_tag != CTA861_EXTENDED_YCBCR420_CAPABILITY_MAP_DATA_BLOCK_TAG)
@@ -541,18 +575,23 @@ namespace Edid {
       return CtaDataBlockType(CTA861_EXTENDED_TAG, CTA861_EXTENDED_COLORIMETRY_BLOCK_TAG);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
     static ColorimetryDataBlock parse_byte_block(const uint8_t* iter) {
       ColorimetryDataBlock result;
 
-      const uint8_t data_block_tag = *iter++ >> 5 & BITMASK_TRUE(3);
+      const uint8_t data_block_tag = *iter >> 5 & BITMASK_TRUE(3);
       if (data_block_tag != CTA861_EXTENDED_TAG)
         throw EdidException(__FUNCTION__, "Extended Tag Data Block has incorrect Data Block Tag: " +
           std::to_string(data_block_tag)
         );
 
+      const uint8_t length = *iter++ & BITMASK_TRUE(5);
+      if (length != CTA861_COLORIMETRY_DATA_BLOCK_LENGTH)
+        throw EdidException(__FUNCTION__, "Colorimetry Data Block has invalid length: " +
+          std::to_string(length));
+
       int extended_tag = *iter++;
       if (extended_tag != CTA861_EXTENDED_COLORIMETRY_BLOCK_TAG)
         throw EdidException(__FUNCTION__, "Colorimetry Data Block has incorrect Extended Data Block Tag: " +
@@ -656,7 +695,7 @@ namespace Edid {
       return CtaDataBlockType(CTA861_EXTENDED_TAG, CTA861_EXTENDED_HDR_STATIC_METADATA_BLOCK_TAG);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
     static HdrStaticMetadataDataBlock parse_byte_block(const uint8_t* iter);
   };
@@ -716,7 +755,7 @@ namespace Edid {
       return CtaDataBlockType(CTA861_EXTENDED_TAG, CTA861_EXTENDED_VIDEO_CAPABILITY_BLOCK_TAG);
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
     static VideoCapabilityDataBlock parse_byte_block(const uint8_t* iter);
   };
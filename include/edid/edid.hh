@@ -1,11 +1,16 @@
 // Copyright 2023 N-Nagorny
 #pragma once
 
+#include <array>
+#include <memory_resource>
 #include <optional>
 #include <vector>
 
 #include "base_block.hh"
 #include "cta861_block.hh"
+#include "parse_result.hh"
+
+#define EDID_BATCH_CHUNK_SIZE 16
 
 namespace Edid {
   struct EdidData {
@@ -18,5 +23,122 @@ namespace Edid {
 #undef FIELDS
 
   std::vector<uint8_t> generate_edid_binary(const EdidData& edid);
+  /** Generates EDID binary straight into caller's memory and returns its size in bytes */
+  size_t generate_edid_binary(
+    const EdidData& edid,  /**< EDID structure */
+    uint8_t* out,  /**< Destination of EDID binary */
+    size_t size  /**< Size of the destination in bytes, throws if EDID binary doesn't fit */
+  );
   EdidData parse_edid_binary(const std::vector<uint8_t>& edid);
+
+  /** Parses EDID binary in place, e.g. straight from a memory-mapped file or a network buffer */
+  EdidData parse_edid_binary(
+    const uint8_t* edid,  /**< Start of EDID binary */
+    size_t size,  /**< Size of EDID binary in bytes */
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()  /**< Memory resource for the containers of extension blocks, e.g. an arena */
+  );
+
+  /** Finds the first error parse_edid_binary would throw on, without throwing or allocating.
+   *  Cheap pre-filter for EDID binaries: it also requires every Data Block Collection to end exactly at its DTD offset.
+   */
+  std::optional<ParseError> check_edid_binary(
+    const uint8_t* edid,  /**< Start of EDID binary */
+    size_t size  /**< Size of EDID binary in bytes */
+  );
+
+  /** Parses EDID binary without throwing on invalid input; errors are reported as ParseError.
+   *  A block which passes check_edid_binary but still fails to parse is reported as PE_MALFORMED at its start.
+   */
+  ParseResult<EdidData> try_parse_edid_binary(
+    const uint8_t* edid,  /**< Start of EDID binary */
+    size_t size,  /**< Size of EDID binary in bytes */
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()  /**< Memory resource for the containers of extension blocks */
+  );
+  ParseResult<EdidData> try_parse_edid_binary(const std::vector<uint8_t>& edid);
+
+  /** Non-owning reference to one EDID binary of a batch */
+  struct EdidBinaryRef {
+    const uint8_t* data;
+    size_t size;
+  };
+
+  /** Parses many EDID binaries concurrently. Results are in input order; an invalid binary
+   *  yields its ParseError and doesn't affect the others.
+   */
+  std::vector<ParseResult<EdidData>> parse_edid_batch(
+    const EdidBinaryRef* edids,  /**< EDID binaries to parse */
+    size_t count,  /**< Number of EDID binaries */
+    unsigned threads = 0  /**< Number of threads including the calling one, 0 for std::thread::hardware_concurrency() */
+  );
+  std::vector<ParseResult<EdidData>> parse_edid_batch(
+    const std::vector<std::vector<uint8_t>>& edids,
+    unsigned threads = 0
+  );
+
+  /** Non-owning view over EDID binary which decodes fields on demand.
+   *  The viewed bytes must outlive the view. Only the header and the size are checked on construction.
+   */
+  class EdidView {
+   public:
+    EdidView(const uint8_t* edid, size_t size);
+    explicit EdidView(const std::vector<uint8_t>& edid)
+      : EdidView(edid.data(), edid.size()) {}
+
+    const uint8_t* data() const { return edid_; }
+    size_t size() const { return size_; }
+
+    /** Number of extension blocks announced by the Base Block and present in the binary */
+    uint8_t extension_blocks() const;
+    /** Start of the block i (0 is the Base Block), nullptr if it does not exist */
+    const uint8_t* block(uint8_t i) const;
+
+    std::array<char, 3> manufacturer_id() const;
+    uint16_t product_code() const;
+    uint32_t serial_number() const;
+    uint8_t edid_major_version() const { return edid_[18]; }
+    uint8_t edid_minor_version() const { return edid_[19]; }
+
+    /** The first 18 byte descriptor of the Base Block if it is a Detailed Timing Descriptor */
+    std::optional<DetailedTimingDescriptor> preferred_dtd() const;
+
+    /** VICs of all Video Data Blocks as stored in EDID (i.e. with the native bit) */
+    std::vector<uint8_t> vics() const;
+    std::optional<uint16_t> hdmi_max_tmds_clock_mhz() const;
+
+    template <class Function>
+    Function for_each_vic(Function fn) const {
+      for_each_data_block([&fn](const uint8_t* data_block) {
+        if ((*data_block >> 5 & BITMASK_TRUE(3)) != CTA861_VIDEO_DATA_BLOCK_TAG)
+          return false;
+        const uint8_t length = *data_block & BITMASK_TRUE(5);
+        for (uint8_t i = 1; i <= length; ++i)
+          fn(data_block[i]);
+        return false;
+      });
+      return fn;
+    }
+
+    /** Calls fn with the start of every CTA-861 data block until fn returns true */
+    template <class Function>
+    void for_each_data_block(Function fn) const {
+      for (unsigned i = 1; i <= extension_blocks(); ++i) {
+        const uint8_t* cta861 = block(i);
+        if (cta861[0] != CTA861_EXT_TAG)
+          continue;
+
+        const uint8_t dtd_start_pos = cta861[2] == 0 ? 4 : std::min<uint8_t>(cta861[2], EDID_BLOCK_SIZE - 1);
+        for (uint8_t pos = 4; pos < dtd_start_pos; pos += 1 + (cta861[pos] & BITMASK_TRUE(5))) {
+          // Skip data blocks running into the DTDs
+          if (pos + 1 + (cta861[pos] & BITMASK_TRUE(5)) > dtd_start_pos)
+            break;
+          if (fn(cta861 + pos))
+            return;
+        }
+      }
+    }
+
+   private:
+    const uint8_t* edid_;
+    size_t size_;
+  };
 }  // namespace Edid
@@ -0,0 +1,75 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef ENABLE_JSON
+#include <nlohmann/json.hpp>
+#endif
+
+#include "edid.hh"
+#include "timing_modes.hh"
+
+#define EDID_CACHE_DEFAULT_MEMORY_BUDGET (4 * 1024 * 1024)
+// Estimated memory taken by an entry besides its binary: parsed EdidData, ModeSet and constraint sets
+#define EDID_CACHE_ENTRY_OVERHEAD 4096
+
+namespace Edid {
+  /** Fast non-cryptographic 64-bit hash of EDID binary */
+  uint64_t hash_edid_binary(const uint8_t* data, size_t size);
+
+  /** Cache of parsed EDIDs and the data derived from them, keyed by the content of EDID binaries.
+   *  Results are shared and immutable, so they stay valid after their entry is evicted.
+   *  The least recently used entries are evicted once the memory budget is exceeded. The budget is approximate:
+   *  an entry is charged its binary size plus the flat EDID_CACHE_ENTRY_OVERHEAD rather than the memory it takes.
+   *  All member functions are safe to call concurrently.
+   */
+  class EdidCache {
+   public:
+    explicit EdidCache(
+      size_t memory_budget = EDID_CACHE_DEFAULT_MEMORY_BUDGET  /**< Budget in bytes, see EDID_CACHE_ENTRY_OVERHEAD */
+    );
+    ~EdidCache();
+
+    /** Parses EDID binary on a miss, throws like parse_edid_binary() */
+    std::shared_ptr<const EdidData> edid(const uint8_t* data, size_t size);
+    std::shared_ptr<const EdidData> edid(const std::vector<uint8_t>& binary);
+
+    /** Collects ModeSet of EDID at first request */
+    std::shared_ptr<const ModeSet> modes(const uint8_t* data, size_t size);
+    std::shared_ptr<const ModeSet> modes(const std::vector<uint8_t>& binary);
+
+#ifdef ENABLE_JSON
+    /** Generates BCP-005-01 constraint sets of EDID at first request */
+    std::shared_ptr<const nlohmann::json> constraint_sets(const uint8_t* data, size_t size);
+    std::shared_ptr<const nlohmann::json> constraint_sets(const std::vector<uint8_t>& binary);
+#endif
+
+    size_t size() const;
+    size_t memory_usage() const;
+    size_t hits() const;
+    size_t misses() const;
+    void clear();
+
+   private:
+    struct Entry;
+    using EntryList = std::list<std::shared_ptr<Entry>>;
+
+    std::shared_ptr<Entry> find_or_parse(const uint8_t* data, size_t size);
+    // Must be called with mutex_ locked
+    void evict();
+
+    const size_t memory_budget_;
+    mutable std::mutex mutex_;
+    EntryList lru_;  // The most recently used entry first
+    std::unordered_map<uint64_t, EntryList::iterator> index_;
+    size_t memory_usage_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+  };
+}  // namespace Edid
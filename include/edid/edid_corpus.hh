@@ -0,0 +1,103 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "edid.hh"
+#include "file_io.hh"
+
+// Layout of the file, all numbers are little-endian:
+//   Header: magic, version (uint32), entry size (uint32), number of records (uint64), index offset (uint64)
+//   EDID binaries packed back to back
+//   Index: one entry per record, see EdidCorpusEntry
+//   Lookup table: record numbers (uint32) ordered by hash, then by record number
+#define EDID_CORPUS_MAGIC "EDIDCORP"
+#define EDID_CORPUS_MAGIC_SIZE 8
+#define EDID_CORPUS_VERSION 1
+#define EDID_CORPUS_HEADER_SIZE 32
+// offset (uint64), hash (uint64), size (uint16), product_code (uint16), manufacturer_id (3 chars), reserved byte
+#define EDID_CORPUS_ENTRY_SIZE 24
+#define EDID_CORPUS_LOOKUP_ENTRY_SIZE 4
+
+namespace Edid {
+  struct EdidCorpusEntry {
+    uint64_t offset;  // Of EDID binary from the start of the file
+    uint64_t hash;  // hash_edid_binary() of EDID binary
+    uint16_t size;  // EDID binary is at most 256 blocks
+    uint16_t product_code;
+    std::array<char, 3> manufacturer_id;
+  };
+
+  /** Writes EDID binaries into a corpus file for EdidCorpus.
+   *  The index is kept in memory and written by close(), the file is incomplete until then.
+   */
+  class EdidCorpusWriter {
+   public:
+    explicit EdidCorpusWriter(const std::string& file_path);
+    /** Closes the file if close() hasn't been called, errors are ignored */
+    ~EdidCorpusWriter();
+
+    EdidCorpusWriter(const EdidCorpusWriter&) = delete;
+    EdidCorpusWriter& operator=(const EdidCorpusWriter&) = delete;
+
+    /** Appends EDID binary as the next record, throws EdidException if it fails check_edid_binary()
+     *  or the corpus already holds 2^32 - 1 records
+     */
+    void add(const uint8_t* edid, size_t size);
+    void add(const std::vector<uint8_t>& edid);
+
+    /** Writes the index, the lookup table and the header */
+    void close();
+
+    /** Number of records added so far */
+    size_t size() const { return index_.size(); }
+
+   private:
+    std::ofstream file_;
+    std::vector<EdidCorpusEntry> index_;
+    uint64_t offset_ = EDID_CORPUS_HEADER_SIZE;
+    bool closed_ = false;
+  };
+
+  /** Read-only corpus of EDID binaries written by EdidCorpusWriter.
+   *  The file is memory-mapped where mmap() is available and read into memory elsewhere,
+   *  so access to any record takes no system calls. The header and all index entries
+   *  are checked when the file is opened, EDID binaries are not.
+   */
+  class EdidCorpus {
+   public:
+    /** Throws EdidException if the file is not a well-formed corpus */
+    explicit EdidCorpus(const std::string& file_path);
+
+    EdidCorpus(const EdidCorpus&) = delete;
+    EdidCorpus& operator=(const EdidCorpus&) = delete;
+
+    /** Number of records */
+    size_t size() const { return size_; }
+
+    /** Index entry of the record i, throws EdidException if there is no such record */
+    EdidCorpusEntry entry(size_t i) const;
+    /** EDID binary of the record i in the mapped file, valid as long as the corpus */
+    EdidView view(size_t i) const;
+
+    /** Index of the first record with the same EDID binary, found by binary search of its hash in the lookup table */
+    std::optional<size_t> find(const uint8_t* edid, size_t size) const;
+    std::optional<size_t> find(const std::vector<uint8_t>& edid) const;
+
+   private:
+    const uint8_t* entry_data(size_t i) const;
+    /** Record number at position i of the lookup table */
+    size_t lookup_record(size_t i) const;
+
+    MappedFile file_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    const uint8_t* index_ = nullptr;
+    const uint8_t* lookup_ = nullptr;
+  };
+}  // namespace Edid
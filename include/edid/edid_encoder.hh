@@ -0,0 +1,56 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "edid.hh"
+
+namespace Edid {
+  /** Keeps EDID structure together with its last generated binary and re-encodes
+   *  only the blocks modified since then.
+   */
+  class EdidEncoder {
+   public:
+    explicit EdidEncoder(EdidData edid);
+
+    const EdidData& edid() const { return edid_; }
+
+    /** Marks the Base Block for re-encoding and calls fn with it.
+     *  fn must not keep the reference: changes made through it after the next binary() call aren't re-encoded.
+     */
+    template <class Function>
+    void modify_base_block(Function&& fn) {
+      dirty_[0] = true;
+      fn(edid_.base_block);
+    }
+
+    /** Marks the extension block i (0-based) for re-encoding and calls fn with it, throws if the block doesn't exist.
+     *  fn must not keep the reference: changes made through it after the next binary() call aren't re-encoded.
+     */
+    template <class Function>
+    void modify_extension_block(size_t i, Function&& fn) {
+      fn(mark_extension_block(i));
+    }
+
+    /** Replaces all extension blocks; every block gets re-encoded as their number may change */
+    void set_extension_blocks(std::optional<std::vector<Cta861Block>> extension_blocks);
+
+    /** Patches the bytes of ID Serial Number and the Base Block checksum in place */
+    void set_serial_number(uint32_t serial_number);
+    /** Patches the bytes of ID Product Code and the Base Block checksum in place */
+    void set_product_code(uint16_t product_code);
+
+    /** EDID binary with all modifications applied */
+    const std::vector<uint8_t>& binary();
+
+   private:
+    size_t extension_blocks_count() const;
+    Cta861Block& mark_extension_block(size_t i);
+
+    EdidData edid_;
+    std::vector<uint8_t> binary_;
+    std::vector<bool> dirty_;  // Per block, 0 is the Base Block
+  };
+}  // namespace Edid
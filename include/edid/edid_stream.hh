@@ -0,0 +1,55 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include "edid.hh"
+
+#define EDID_STREAM_READ_SIZE (16 * EDID_BLOCK_SIZE)
+
+namespace Edid {
+  /** Reads EDIDs one by one from a stream of concatenated EDID binaries, e.g. an archive file.
+   *  At most one EDID (up to 256 blocks) plus EDID_STREAM_READ_SIZE bytes are buffered.
+   *  Records which fail the checks of check_edid_binary or parsing are skipped by
+   *  resynchronising on the next Base Block header.
+   */
+  class EdidStreamReader {
+   public:
+    explicit EdidStreamReader(
+      std::istream& is,  /**< Stream of concatenated EDID binaries, opened in binary mode */
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()  /**< Memory resource for the containers of extension blocks */
+    );
+
+    /** Parses the next valid EDID of the stream, std::nullopt at the end of it */
+    std::optional<EdidData> next();
+    /** Finds the next valid EDID of the stream without parsing it.
+     *  The view is invalidated by the next call to next() or next_view().
+     */
+    std::optional<EdidView> next_view();
+
+    /** Stream offset of the EDID returned by the last call to next() or next_view() */
+    size_t offset() const { return offset_; }
+    /** Number of bytes skipped so far because they didn't belong to a valid EDID */
+    size_t skipped_bytes() const { return skipped_bytes_; }
+
+   private:
+    // Returns the size of the valid EDID at the start of the window, 0 at the end of the stream
+    size_t find_edid();
+    // Makes at least size bytes available in the window, false if the stream ends earlier
+    bool fill(size_t size);
+    void consume(size_t size);
+    void skip(size_t size);
+
+    std::istream& is_;
+    std::pmr::memory_resource* resource_;
+    std::vector<uint8_t> buffer_;
+    size_t begin_ = 0;  // Start of the window in buffer_
+    size_t position_ = 0;  // Stream offset of the start of the window
+    size_t offset_ = 0;
+    size_t skipped_bytes_ = 0;
+  };
+}  // namespace Edid
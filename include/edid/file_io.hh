@@ -0,0 +1,51 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Files which load_directory() opens and asks the kernel to prefetch before reading them
+#define EDID_LOAD_DIRECTORY_BATCH 64
+
+namespace Edid {
+  /** Reads the whole regular file, throws std::runtime_error if it can't be read */
+  std::vector<uint8_t> read_file(const std::string& file_path);
+
+  /** Read-only contents of a file, memory-mapped where mmap() is available and read into memory elsewhere.
+   *  Throws std::runtime_error like read_file() if the file can't be read.
+   */
+  class MappedFile {
+   public:
+    explicit MappedFile(const std::string& file_path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** nullptr for an empty file */
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+   private:
+    void unmap();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> contents_;  // The file if it isn't memory-mapped
+  };
+
+  struct LoadedFile {
+    std::string path;
+    std::vector<uint8_t> contents;
+  };
+
+  /** Reads all regular files of the directory, sorted by their paths. Files are opened in batches
+   *  of EDID_LOAD_DIRECTORY_BATCH and the kernel is asked to prefetch a whole batch before it's read,
+   *  so reads of a cold corpus overlap. Throws std::runtime_error if any file can't be read.
+   */
+  std::vector<LoadedFile> load_directory(const std::string& directory_path, bool recursive = false);
+}  // namespace Edid
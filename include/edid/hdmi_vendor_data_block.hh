@@ -1,6 +1,7 @@
 // Copyright 2023 N-Nagorny
 #pragma once
 
+#include <memory_resource>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -168,9 +169,9 @@ namespace Edid {
   // (HDMI1.4b Section 8.3.2)
   struct HdmiVideoSubblock {
     ImageSizeMeaning image_size_meaning = ISM_NO_INFO;
-    std::vector<uint8_t> hdmi_vics;
+    std::pmr::vector<uint8_t> hdmi_vics;
     std::optional<StereoVideoSupport> stereo_video_support;
-    std::vector<Vic3dSupport> vic_3d_support;
+    std::pmr::vector<Vic3dSupport> vic_3d_support;
   };
 
 #define FIELDS(X) X.image_size_meaning, X.hdmi_vics, X.stereo_video_support, X.vic_3d_support
@@ -289,10 +290,13 @@ namespace Edid {
       return result;
     }
 
-    std::vector<uint8_t> generate_byte_block() const override;
+    uint8_t* write_byte_block(uint8_t* out) const override;
     void print(std::ostream& os, uint8_t tabs = 1) const override;
 
-    static HdmiVendorDataBlock parse_byte_block(const uint8_t* start) {
+    static HdmiVendorDataBlock parse_byte_block(
+      const uint8_t* start,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) {
       HdmiVendorDataBlock result;
 
       // byte 8
@@ -377,7 +381,12 @@ namespace Edid {
             std::to_string(length)
           );
 
-        HdmiVideoSubblock subblock;
+        HdmiVideoSubblock subblock{
+          ISM_NO_INFO,
+          std::pmr::vector<uint8_t>(resource),
+          std::nullopt,
+          std::pmr::vector<Vic3dSupport>(resource)
+        };
         uint8_t byte_13 = *start++;
         uint8_t byte_14 = *start++;
 
@@ -417,7 +426,6 @@ namespace Edid {
           hdmi_3d_len -= 2;
         }
 
-        std::vector<Vic3dSupport> vic_3d_support;
         while (hdmi_3d_len > 0) {
           Vic3dSupport vic_3d_item;
           vic_3d_item.vic_index = *start >> 4 & BITMASK_TRUE(4);
@@ -426,14 +434,11 @@ namespace Edid {
           if (stereo_video_structure_x >= 0b1000 && stereo_video_structure_x <= 0b1111) {
             vic_3d_item.subsampling_3d = StereoVideoSubsampling(*start++ >> 4 & BITMASK_TRUE(4));
           }
-          vic_3d_support.push_back(vic_3d_item);
+          subblock.vic_3d_support.push_back(vic_3d_item);
           hdmi_3d_len--;
         }
-        if (!vic_3d_support.empty()) {
-          subblock.vic_3d_support = std::move(vic_3d_support);
-        }
 
-        result.hdmi_video = subblock;
+        result.hdmi_video = std::move(subblock);
       }
 
       return result;
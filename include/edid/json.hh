@@ -1,6 +1,9 @@
 // Copyright 2023 N-Nagorny
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include <nlohmann/json.hpp>
 
 #include "edid.hh"
@@ -88,4 +91,38 @@ namespace Edid {
   void to_json(nlohmann::json& j, const StereoVideoSupport&);
   void to_json(nlohmann::json& j, const HdmiVideoSubblock&);
   void to_json(nlohmann::json& j, const HdmiVendorDataBlock& block);
+
+  /** JSON known to satisfy the edid.json schema, so that it can be deserialized without validation */
+  class ValidatedEdidJson {
+   public:
+    /** Trusted input: JSON of EdidData is correct by construction and isn't validated */
+    explicit ValidatedEdidJson(const EdidData& edid);
+    /** Untrusted input: throws EdidException if the JSON doesn't satisfy the edid.json schema */
+    static ValidatedEdidJson validate(nlohmann::json j);
+
+    const nlohmann::json& json() const { return json_; }
+    EdidData edid() const;
+
+   private:
+    explicit ValidatedEdidJson(nlohmann::json j) : json_(std::move(j)) {}
+
+    nlohmann::json json_;
+  };
+
+  /** Validates untrusted JSON against the edid.json schema and deserializes it,
+   *  throws EdidException if either of them fails
+   */
+  EdidData parse_edid_json(const nlohmann::json& j);
+
+  /** CBOR and MessagePack of EdidData are structured like its JSON, see nlohmann::json::to_cbor() */
+  std::vector<uint8_t> generate_edid_cbor(const EdidData& edid);
+  std::vector<uint8_t> generate_edid_msgpack(const EdidData& edid);
+
+  /** Deserializes CBOR or MessagePack of EdidData without validation against the edid.json schema,
+   *  throws EdidException if the input is malformed or isn't structured like JSON of EdidData
+   */
+  EdidData parse_edid_cbor(const uint8_t* data, size_t size);
+  EdidData parse_edid_cbor(const std::vector<uint8_t>& cbor);
+  EdidData parse_edid_msgpack(const uint8_t* data, size_t size);
+  EdidData parse_edid_msgpack(const std::vector<uint8_t>& msgpack);
 }  // namespace Edid
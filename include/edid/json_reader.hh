@@ -0,0 +1,20 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <string>
+
+#include "edid.hh"
+
+// Nesting of JSON containers which the reader is ready to descend, deeper input is rejected
+#define EDID_JSON_READER_MAX_DEPTH 64
+
+namespace Edid {
+  /** Deserializes EdidData from JSON text in one pass without building nlohmann::json.
+   *  Reads what write_edid_json() and nlohmann::json(edid).dump() produce, members in any order.
+   *  Syntax and types of values are checked, the edid.json schema is not: unknown members are skipped
+   *  and missing ones keep their default values. Numbers must be non-negative integers in range of
+   *  their fields. Throws EdidException with the offset of the first malformed byte.
+   */
+  EdidData read_edid_json(const char* data, size_t size);
+  EdidData read_edid_json(const std::string& text);
+}  // namespace Edid
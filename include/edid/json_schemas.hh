@@ -2,7 +2,6 @@
 
 #pragma once
 
-#include <map>
 #include <string>
 
 #include <nlohmann/json.hpp>
@@ -40,37 +39,16 @@ namespace Edid {
       extern const char* ycbcr420_capability_map_data_block;
     }  // namespace cta861_block
 
-    static const std::map<json_uri, json> schemas = {
-      { json_uri{"base_block.json"}, json::parse(base_block::base_block) },
-      { json_uri{"standard_timing.json"}, json::parse(base_block::standard_timing) },
+    /** Schema by its URI, e.g. "edid.json", parsed once process-wide at first request.
+     *  Throws std::runtime_error if there is no such schema.
+     */
+    const json& get_schema(const json_uri& uri);
 
-      { json_uri{"ascii_string.json"}, json::parse(common::ascii_string) },
-      { json_uri{"detailed_timing_descriptor.json"}, json::parse(common::detailed_timing_descriptor) },
-      { json_uri{"edid.json"}, json::parse(common::edid) },
-      { json_uri{"display_range_limits.json"}, json::parse(common::display_range_limits) },
-      { json_uri{"established_timings_3.json"}, json::parse(common::established_timings_3) },
+    /** Loads $ref-erenced schemas via get_schema() */
+    void schema_loader(const json_uri& id, json& value);
 
-      { json_uri{"audio_data_block.json"}, json::parse(cta861_block::audio_data_block) },
-      { json_uri{"colorimetry_data_block.json"}, json::parse(cta861_block::colorimetry_data_block) },
-      { json_uri{"cta861_block.json"}, json::parse(cta861_block::cta861_block) },
-      { json_uri{"hdmi_vsdb.json"}, json::parse(cta861_block::hdmi_vsdb) },
-      { json_uri{"hdr_static_metadata_data_block.json"}, json::parse(cta861_block::hdr_static_metadata_data_block) },
-      { json_uri{"speaker_allocation_data_block.json"}, json::parse(cta861_block::speaker_allocation_data_block) },
-      { json_uri{"unknown_data_block.json"}, json::parse(cta861_block::unknown_data_block) },
-      { json_uri{"video_capability_data_block.json"}, json::parse(cta861_block::video_capability_data_block) },
-      { json_uri{"video_data_block.json"}, json::parse(cta861_block::video_data_block) },
-      { json_uri{"ycbcr420_capability_map_data_block.json"}, json::parse(cta861_block::ycbcr420_capability_map_data_block) },
-    };
-
-    static nlohmann::json_schema::schema_loader schema_loader = [](const json_uri& id, json& value) {
-      auto found = schemas.find(id);
-
-      if (found == schemas.end()) {
-        throw std::runtime_error("JSON Schema not found for " + id.to_string());
-      }
-
-      value = found->second;
-    };
+    /** Validator of the schema compiled once process-wide at first request, safe to use concurrently */
+    const nlohmann::json_schema::json_validator& get_validator(const std::string& uri);
 
     bool is_json_satisfies_schema(const std::string& uri, const json& j);
   }  // namespace json_schemas
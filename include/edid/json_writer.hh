@@ -0,0 +1,23 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "edid.hh"
+
+namespace Edid {
+  /** Appends JSON of EDID to out without building nlohmann::json. The output is
+   *  byte-identical to nlohmann::json(edid).dump(indent), keys are sorted the same way.
+   *  Strings are written as is apart from escaping, so ASCII descriptors with bytes above 0x7F
+   *  produce JSON which nlohmann::json would refuse to dump as invalid UTF-8.
+   */
+  void write_edid_json(
+    const EdidData& edid,
+    std::string& out,  /**< Growable buffer, e.g. reused across a corpus of EDIDs */
+    int indent = -1  /**< Same as for nlohmann::json::dump(), -1 is the compact form */
+  );
+
+  /** Writes JSON of EDID to the stream, see write_edid_json(const EdidData&, std::string&, int) */
+  void write_edid_json(const EdidData& edid, std::ostream& os, int indent = -1);
+}  // namespace Edid
@@ -0,0 +1,95 @@
+// Copyright 2023 N-Nagorny
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include "common.hh"
+#include "exceptions.hh"
+
+namespace Edid {
+  enum ParseErrorCode {
+    PE_INVALID_SIZE,
+    PE_TRUNCATED,
+    PE_INVALID_HEADER,
+    PE_INVALID_CHECKSUM,
+    PE_UNKNOWN_DISPLAY_DESCRIPTOR,
+    PE_INVALID_EXTENSION_TAG,
+    PE_UNSUPPORTED_EXTENSION_VERSION,
+    PE_INVALID_DTD_OFFSET,
+    PE_INVALID_DATA_BLOCK_LENGTH,
+    PE_DATA_BLOCK_OVERRUN,
+    PE_MALFORMED
+  };
+
+  STRINGIFY_ENUM(ParseErrorCode, {
+    {PE_INVALID_SIZE,                  "Invalid size"},
+    {PE_TRUNCATED,                     "Truncated"},
+    {PE_INVALID_HEADER,                "Invalid header"},
+    {PE_INVALID_CHECKSUM,              "Invalid checksum"},
+    {PE_UNKNOWN_DISPLAY_DESCRIPTOR,    "Unknown Display Descriptor"},
+    {PE_INVALID_EXTENSION_TAG,         "Invalid Extension Tag"},
+    {PE_UNSUPPORTED_EXTENSION_VERSION, "Unsupported extension version"},
+    {PE_INVALID_DTD_OFFSET,            "Invalid DTD offset"},
+    {PE_INVALID_DATA_BLOCK_LENGTH,     "Invalid Data Block length"},
+    {PE_DATA_BLOCK_OVERRUN,            "Data Block overrun"},
+    {PE_MALFORMED,                     "Malformed"},
+  })
+
+  // Cheap to produce: the message is only built when asked for
+  struct ParseError {
+    ParseErrorCode code;
+    uint8_t block_index = 0;  // 0 is the Base Block
+    size_t byte_offset = 0;  // From the start of EDID binary
+    uint32_t value = 0;  // The offending value, e.g. the read tag or length
+
+    std::string message() const;
+  };
+
+#define FIELDS(X) X.code, X.block_index, X.byte_offset, X.value
+  TIED_OP(ParseError, ==, FIELDS)
+#undef FIELDS
+
+  /** Either a parsed value or the first error found in the binary, like std::expected */
+  template <class T>
+  class ParseResult {
+   public:
+    ParseResult(T value)
+      : result_(std::move(value)) {}
+    ParseResult(const ParseError& error)
+      : result_(error) {}
+
+    bool has_value() const { return result_.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+
+    T& value() & {
+      throw_if_error();
+      return std::get<T>(result_);
+    }
+    const T& value() const & {
+      throw_if_error();
+      return std::get<T>(result_);
+    }
+    T&& value() && {
+      throw_if_error();
+      return std::get<T>(std::move(result_));
+    }
+
+    T& operator*() & { return std::get<T>(result_); }
+    const T& operator*() const & { return std::get<T>(result_); }
+    T* operator->() { return &std::get<T>(result_); }
+    const T* operator->() const { return &std::get<T>(result_); }
+
+    const ParseError& error() const { return std::get<ParseError>(result_); }
+
+   private:
+    void throw_if_error() const {
+      if (!has_value())
+        throw EdidException(error().message());
+    }
+
+    std::variant<T, ParseError> result_;
+  };
+}  // namespace Edid
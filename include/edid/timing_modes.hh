@@ -1,7 +1,9 @@
 // Copyright 2023 N-Nagorny
 #pragma once
 
-#include <map>
+#include <array>
+#include <cstddef>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -14,6 +16,13 @@ namespace Edid {
 
   using Ratio = std::pair<uint64_t, uint64_t>;
 
+// Rates this close to an integer or NTSC (x 1000/1001) one are snapped to it, which absorbs
+// the 10 kHz granularity of DTD pixel clocks
+#define RATE_TOLERANCE_PPM 100
+
+  /** Reduces the rate by gcd, snapping it to N/1 or N*1000/1001 when within RATE_TOLERANCE_PPM */
+  Ratio canonical_rate(const Ratio& rate);
+
   struct VideoTimingMode {
     uint16_t h_res;
     uint16_t v_res;
@@ -25,162 +34,283 @@ namespace Edid {
   TIED_COMPARISONS(VideoTimingMode, FIELDS)
 #undef FIELDS
 
+  struct Cta861TimingFeatures {
+    bool interlaced;
+    StereoMode stereo_mode;
+    DigitalSeparateSync sync;
+  };
+
+  // Trivially copyable counterpart of DetailedTimingDescriptor for compile-time tables
+  struct Cta861Timing {
+    uint64_t pixel_clock_hz;
+    uint16_t h_res;
+    uint16_t v_res;
+    uint16_t h_blanking;
+    uint16_t v_blanking;
+    uint16_t h_front_porch;
+    uint16_t h_sync_width;
+    uint8_t v_front_porch;
+    uint8_t v_sync_width;
+    uint16_t h_image_size;
+    uint16_t v_image_size;
+    uint8_t h_border_pixels;
+    uint8_t v_border_lines;
+    Cta861TimingFeatures features_bitmap;
+
+    DetailedTimingDescriptor to_dtd() const;
+  };
+
   struct Cta861VideoTimingMode {
-    DetailedTimingDescriptor dtd;
-    std::variant<uint8_t, std::pair<uint8_t, uint8_t>, std::vector<uint8_t>> pixel_repetition_factor;
+    Cta861Timing dtd;
+    uint16_t pixel_repetition_factors;  // Bit n - 1 is set if the factor n is allowed
+
+    constexpr uint8_t min_pixel_repetition_factor() const {
+      uint8_t factor = 1;
+      while (factor < 16 && !(pixel_repetition_factors >> (factor - 1) & 1))
+        ++factor;
+      return factor;
+    }
   };
 
-  const std::map<EstablishedTiming1, VideoTimingMode> et_1_to_video_mode = {
-    {ET_720x400_70, { 720, 400, {70, 1}, false }},
-    {ET_720x400_88, { 720, 400, {88, 1}, false }},
-    {ET_640x480_60, { 640, 480, {60, 1}, false }},
-    {ET_640x480_67, { 640, 480, {67, 1}, false }},
-    {ET_640x480_72, { 640, 480, {72, 1}, false }},
-    {ET_640x480_75, { 640, 480, {75, 1}, false }},
-    {ET_800x600_56, { 800, 600, {56, 1}, false }},
-    {ET_800x600_60, { 800, 600, {60, 1}, false }}
+  // Tables of timings defined by bits are indexed by the bit position, an empty mode marks a reserved bit
+  inline constexpr VideoTimingMode et_1_video_modes[8] = {
+    { 800, 600, {60, 1}, false },  // ET_800x600_60
+    { 800, 600, {56, 1}, false },  // ET_800x600_56
+    { 640, 480, {75, 1}, false },  // ET_640x480_75
+    { 640, 480, {72, 1}, false },  // ET_640x480_72
+    { 640, 480, {67, 1}, false },  // ET_640x480_67
+    { 640, 480, {60, 1}, false },  // ET_640x480_60
+    { 720, 400, {88, 1}, false },  // ET_720x400_88
+    { 720, 400, {70, 1}, false },  // ET_720x400_70
   };
 
-  const std::map<EstablishedTiming2, VideoTimingMode> et_2_to_video_mode = {
-    {ET_800x600_72,   { 800, 600,   {72, 1}, false }},
-    {ET_800x600_75,   { 800, 600,   {75, 1}, false }},
-    {ET_832x624_75,   { 832, 624,   {75, 1}, false }},
-    {ET_1024x768i_87, { 1024, 768,  {87, 1}, true }},
-    {ET_1024x768_60,  { 1024, 768,  {60, 1}, false }},
-    {ET_1024x768_70,  { 1024, 768,  {70, 1}, false }},
-    {ET_1024x768_75,  { 1024, 768,  {75, 1}, false }},
-    {ET_1280x1024_75, { 1280, 1024, {75, 1}, false }}
+  inline constexpr VideoTimingMode et_2_video_modes[8] = {
+    { 1280, 1024, {75, 1}, false },  // ET_1280x1024_75
+    { 1024, 768, {75, 1}, false },  // ET_1024x768_75
+    { 1024, 768, {70, 1}, false },  // ET_1024x768_70
+    { 1024, 768, {60, 1}, false },  // ET_1024x768_60
+    { 1024, 768, {87, 1}, true },  // ET_1024x768i_87
+    { 832, 624, {75, 1}, false },  // ET_832x624_75
+    { 800, 600, {75, 1}, false },  // ET_800x600_75
+    { 800, 600, {72, 1}, false },  // ET_800x600_72
   };
 
-  const std::map<ManufacturersTiming, VideoTimingMode> mt_to_video_mode = {
-    {ET_1152x870_75,   { 1152, 870, {75, 1}, false }}
+  inline constexpr VideoTimingMode mt_video_modes[8] = {
+    {},
+    {},
+    {},
+    {},
+    {},
+    {},
+    {},
+    { 1152, 870, {75, 1}, false },  // ET_1152x870_75
   };
 
-  const std::map<std::pair<uint8_t, uint8_t>, VideoTimingMode> et_3_to_video_mode = {
-    {{0, ET_640x350_85},   { 640, 350,   {85, 1}, false }},
-    {{0, ET_640x400_85},   { 640, 400,   {85, 1}, false }},
-    {{0, ET_720x400_85},   { 720, 400,   {85, 1}, false }},
-    {{0, ET_640x480_85},   { 640, 480,   {85, 1}, false }},
-    {{0, ET_848x480_60},   { 848, 480,   {60, 1}, false }},
-    {{0, ET_800x600_85},   { 800, 600,   {85, 1}, false }},
-    {{0, ET_1024x768_85},  { 1024, 768,  {85, 1}, false }},
-    {{0, ET_1152x864_75},  { 1152, 864,  {75, 1}, false }},
-
-    {{1, ET_1280x768_60_RB},   { 1280, 768,   {60, 1}, false }},
-    {{1, ET_1280x768_60},      { 1280, 768,   {60, 1}, false }},
-    {{1, ET_1280x768_75},      { 1280, 768,   {75, 1}, false }},
-    {{1, ET_1280x768_85},      { 1280, 768,   {85, 1}, false }},
-    {{1, ET_1280x960_60},      { 1280, 960,   {60, 1}, false }},
-    {{1, ET_1280x960_85},      { 1280, 960,   {85, 1}, false }},
-    {{1, ET_1280x1024_60},     { 1280, 1024,  {60, 1}, false }},
-    {{1, ET_1280x1024_85},     { 1280, 1024,  {85, 1}, false }},
-
-    {{2, ET_1360x768_60},      { 1360, 768,   {60, 1}, false }},
-    {{2, ET_1440x900_60_RB},   { 1440, 900,   {60, 1}, false }},
-    {{2, ET_1440x900_60},      { 1440, 900,   {60, 1}, false }},
-    {{2, ET_1440x900_75},      { 1440, 900,   {75, 1}, false }},
-    {{2, ET_1440x900_85},      { 1440, 900,   {85, 1}, false }},
-    {{2, ET_1440x1050_60_RB},  { 1440, 1050,  {60, 1}, false }},
-    {{2, ET_1440x1050_60},     { 1440, 1050,  {60, 1}, false }},
-    {{2, ET_1440x1050_75},     { 1440, 1050,  {75, 1}, false }},
-
-    {{3, ET_1400x1050_85},     { 1440, 1050,  {85, 1}, false }},
-    {{3, ET_1680x1050_60_RB},  { 1680, 1050,  {60, 1}, false }},
-    {{3, ET_1680x1050_60},     { 1680, 1050,  {60, 1}, false }},
-    {{3, ET_1680x1050_75},     { 1680, 1050,  {75, 1}, false }},
-    {{3, ET_1680x1050_85},     { 1680, 1050,  {85, 1}, false }},
-    {{3, ET_1600x1200_60},     { 1600, 1200,  {60, 1}, false }},
-    {{3, ET_1600x1200_65},     { 1600, 1200,  {65, 1}, false }},
-    {{3, ET_1600x1200_70},     { 1600, 1200,  {70, 1}, false }},
-
-    {{4, ET_1600x1200_75},     { 1600, 1200,  {75, 1}, false }},
-    {{4, ET_1600x1200_85},     { 1600, 1200,  {85, 1}, false }},
-    {{4, ET_1792x1344_60},     { 1792, 1344,  {60, 1}, false }},
-    {{4, ET_1792x1344_75},     { 1792, 1344,  {75, 1}, false }},
-    {{4, ET_1856x1392_60},     { 1856, 1392,  {60, 1}, false }},
-    {{4, ET_1856x1392_75},     { 1856, 1392,  {75, 1}, false }},
-    {{4, ET_1920x1200_60_RB},  { 1920, 1200,  {60, 1}, false }},
-    {{4, ET_1920x1200_60},     { 1920, 1200,  {60, 1}, false }},
-
-    {{5, ET_1920x1200_75},     { 1920, 1200,  {75, 1}, false }},
-    {{5, ET_1920x1200_85},     { 1920, 1200,  {85, 1}, false }},
-    {{5, ET_1920x1440_60},     { 1920, 1440,  {60, 1}, false }},
-    {{5, ET_1920x1440_75},     { 1920, 1440,  {75, 1}, false }}
+  // Byte i of Established Timings III is at [i][bit position]
+  inline constexpr VideoTimingMode et_3_video_modes[6][8] = {
+    {
+      { 1152, 864, {75, 1}, false },  // ET_1152x864_75
+      { 1024, 768, {85, 1}, false },  // ET_1024x768_85
+      { 800, 600, {85, 1}, false },  // ET_800x600_85
+      { 848, 480, {60, 1}, false },  // ET_848x480_60
+      { 640, 480, {85, 1}, false },  // ET_640x480_85
+      { 720, 400, {85, 1}, false },  // ET_720x400_85
+      { 640, 400, {85, 1}, false },  // ET_640x400_85
+      { 640, 350, {85, 1}, false },  // ET_640x350_85
+    },
+    {
+      { 1280, 1024, {85, 1}, false },  // ET_1280x1024_85
+      { 1280, 1024, {60, 1}, false },  // ET_1280x1024_60
+      { 1280, 960, {85, 1}, false },  // ET_1280x960_85
+      { 1280, 960, {60, 1}, false },  // ET_1280x960_60
+      { 1280, 768, {85, 1}, false },  // ET_1280x768_85
+      { 1280, 768, {75, 1}, false },  // ET_1280x768_75
+      { 1280, 768, {60, 1}, false },  // ET_1280x768_60
+      { 1280, 768, {60, 1}, false },  // ET_1280x768_60_RB
+    },
+    {
+      { 1440, 1050, {75, 1}, false },  // ET_1440x1050_75
+      { 1440, 1050, {60, 1}, false },  // ET_1440x1050_60
+      { 1440, 1050, {60, 1}, false },  // ET_1440x1050_60_RB
+      { 1440, 900, {85, 1}, false },  // ET_1440x900_85
+      { 1440, 900, {75, 1}, false },  // ET_1440x900_75
+      { 1440, 900, {60, 1}, false },  // ET_1440x900_60
+      { 1440, 900, {60, 1}, false },  // ET_1440x900_60_RB
+      { 1360, 768, {60, 1}, false },  // ET_1360x768_60
+    },
+    {
+      { 1600, 1200, {70, 1}, false },  // ET_1600x1200_70
+      { 1600, 1200, {65, 1}, false },  // ET_1600x1200_65
+      { 1600, 1200, {60, 1}, false },  // ET_1600x1200_60
+      { 1680, 1050, {85, 1}, false },  // ET_1680x1050_85
+      { 1680, 1050, {75, 1}, false },  // ET_1680x1050_75
+      { 1680, 1050, {60, 1}, false },  // ET_1680x1050_60
+      { 1680, 1050, {60, 1}, false },  // ET_1680x1050_60_RB
+      { 1440, 1050, {85, 1}, false },  // ET_1400x1050_85
+    },
+    {
+      { 1920, 1200, {60, 1}, false },  // ET_1920x1200_60
+      { 1920, 1200, {60, 1}, false },  // ET_1920x1200_60_RB
+      { 1856, 1392, {75, 1}, false },  // ET_1856x1392_75
+      { 1856, 1392, {60, 1}, false },  // ET_1856x1392_60
+      { 1792, 1344, {75, 1}, false },  // ET_1792x1344_75
+      { 1792, 1344, {60, 1}, false },  // ET_1792x1344_60
+      { 1600, 1200, {85, 1}, false },  // ET_1600x1200_85
+      { 1600, 1200, {75, 1}, false },  // ET_1600x1200_75
+    },
+    {
+      {},
+      {},
+      {},
+      {},
+      { 1920, 1440, {75, 1}, false },  // ET_1920x1440_75
+      { 1920, 1440, {60, 1}, false },  // ET_1920x1440_60
+      { 1920, 1200, {85, 1}, false },  // ET_1920x1200_85
+      { 1920, 1200, {75, 1}, false },  // ET_1920x1200_75
+    },
   };
 
-  const std::map<std::pair<uint8_t, uint8_t>, VideoTimingMode> std_2_byte_code_to_video_mode = {
-    { {0x31, 0x19}, { 640, 400,   { 85, 1 }, false } },
-    { {0x31, 0x40}, { 640, 480,   { 60, 1 }, false } },
-    { {0x31, 0x4c}, { 640, 480,   { 72, 1 }, false } },
-    { {0x31, 0x4f}, { 640, 480,   { 75, 1 }, false } },
-    { {0x31, 0x59}, { 640, 480,   { 85, 1 }, false } },
-    { {0x45, 0x40}, { 800, 600,   { 60, 1 }, false } },
-    { {0x45, 0x4c}, { 800, 600,   { 72, 1 }, false } },
-    { {0x45, 0x4f}, { 800, 600,   { 75, 1 }, false } },
-    { {0x45, 0x59}, { 800, 600,   { 85, 1 }, false } },
-    { {0x61, 0x40}, { 1024, 768,  { 60, 1 }, false } },
-    { {0x61, 0x4c}, { 1024, 768,  { 70, 1 }, false } },
-    { {0x61, 0x4f}, { 1024, 768,  { 75, 1 }, false } },
-    { {0x61, 0x59}, { 1024, 768,  { 85, 1 }, false } },
-    { {0x71, 0x4f}, { 1152, 864,  { 75, 1 }, false } },
-    { {0x81, 0xc0}, { 1280, 720,  { 60, 1 }, false } },
-    { {0x81, 0x00}, { 1280, 800,  { 60, 1 }, false } },
-    { {0x81, 0x0f}, { 1280, 800,  { 75, 1 }, false } },
-    { {0x81, 0x19}, { 1280, 800,  { 85, 1 }, false } },
-    { {0x81, 0x40}, { 1280, 960,  { 60, 1 }, false } },
-    { {0x81, 0x59}, { 1280, 960,  { 85, 1 }, false } },
-    { {0x81, 0x80}, { 1280, 1024, { 60, 1 }, false } },
-    { {0x81, 0x8f}, { 1280, 1024, { 75, 1 }, false } },
-    { {0x81, 0x99}, { 1280, 1024, { 85, 1 }, false } },
-    { {0x90, 0x40}, { 1400, 1050, { 60, 1 }, false } },
-    { {0x90, 0x4f}, { 1400, 1050, { 75, 1 }, false } },
-    { {0x90, 0x59}, { 1400, 1050, { 85, 1 }, false } },
-    { {0x95, 0x00}, { 1440, 900,  { 60, 1 }, false } },
-    { {0x95, 0x0f}, { 1440, 900,  { 75, 1 }, false } },
-    { {0x95, 0x19}, { 1440, 900,  { 85, 1 }, false } },
-    { {0xa9, 0xc0}, { 1600, 900,  { 60, 1 }, false } },
-    { {0xa9, 0x40}, { 1600, 1200, { 60, 1 }, false } },
-    { {0xa9, 0x45}, { 1600, 1200, { 65, 1 }, false } },
-    { {0xa9, 0x4a}, { 1600, 1200, { 70, 1 }, false } },
-    { {0xa9, 0x4f}, { 1600, 1200, { 75, 1 }, false } },
-    { {0xa9, 0x59}, { 1600, 1200, { 85, 1 }, false } },
-    { {0xb3, 0x00}, { 1680, 1050, { 60, 1 }, false } },
-    { {0xb3, 0x0f}, { 1680, 1050, { 75, 1 }, false } },
-    { {0xb3, 0x19}, { 1680, 1050, { 85, 1 }, false } },
-    { {0xc1, 0x40}, { 1792, 1344, { 60, 1 }, false } },
-    { {0xc1, 0x4f}, { 1792, 1344, { 75, 1 }, false } },
-    { {0xc9, 0x40}, { 1856, 1392, { 60, 1 }, false } },
-    { {0xc9, 0x4f}, { 1856, 1392, { 75, 1 }, false } },
-    { {0xd1, 0xc0}, { 1920, 1080, { 60, 1 }, false } },
-    { {0xd1, 0x00}, { 1920, 1200, { 60, 1 }, false } },
-    { {0xd1, 0x0f}, { 1920, 1200, { 75, 1 }, false } },
-    { {0xd1, 0x19}, { 1920, 1200, { 85, 1 }, false } },
-    { {0xd1, 0x40}, { 1920, 1440, { 60, 1 }, false } },
-    { {0xd1, 0x4f}, { 1920, 1440, { 75, 1 }, false } },
-    { {0xe1, 0xc0}, { 2048, 1152, { 60, 1 }, false } }
+  struct StandardTimingVideoMode {
+    uint16_t code;  // Both bytes of Standard Timing, the first one in the high byte
+    VideoTimingMode mode;
   };
 
-  std::optional<Cta861VideoTimingMode> get_cta861_video_timing_mode(uint8_t vic);
+  inline constexpr StandardTimingVideoMode std_2_byte_code_video_modes[] = {
+    { 0x3119, { 640, 400,   { 85, 1 }, false } },
+    { 0x3140, { 640, 480,   { 60, 1 }, false } },
+    { 0x314C, { 640, 480,   { 72, 1 }, false } },
+    { 0x314F, { 640, 480,   { 75, 1 }, false } },
+    { 0x3159, { 640, 480,   { 85, 1 }, false } },
+    { 0x4540, { 800, 600,   { 60, 1 }, false } },
+    { 0x454C, { 800, 600,   { 72, 1 }, false } },
+    { 0x454F, { 800, 600,   { 75, 1 }, false } },
+    { 0x4559, { 800, 600,   { 85, 1 }, false } },
+    { 0x6140, { 1024, 768,  { 60, 1 }, false } },
+    { 0x614C, { 1024, 768,  { 70, 1 }, false } },
+    { 0x614F, { 1024, 768,  { 75, 1 }, false } },
+    { 0x6159, { 1024, 768,  { 85, 1 }, false } },
+    { 0x714F, { 1152, 864,  { 75, 1 }, false } },
+    { 0x81C0, { 1280, 720,  { 60, 1 }, false } },
+    { 0x8100, { 1280, 800,  { 60, 1 }, false } },
+    { 0x810F, { 1280, 800,  { 75, 1 }, false } },
+    { 0x8119, { 1280, 800,  { 85, 1 }, false } },
+    { 0x8140, { 1280, 960,  { 60, 1 }, false } },
+    { 0x8159, { 1280, 960,  { 85, 1 }, false } },
+    { 0x8180, { 1280, 1024, { 60, 1 }, false } },
+    { 0x818F, { 1280, 1024, { 75, 1 }, false } },
+    { 0x8199, { 1280, 1024, { 85, 1 }, false } },
+    { 0x9040, { 1400, 1050, { 60, 1 }, false } },
+    { 0x904F, { 1400, 1050, { 75, 1 }, false } },
+    { 0x9059, { 1400, 1050, { 85, 1 }, false } },
+    { 0x9500, { 1440, 900,  { 60, 1 }, false } },
+    { 0x950F, { 1440, 900,  { 75, 1 }, false } },
+    { 0x9519, { 1440, 900,  { 85, 1 }, false } },
+    { 0xA9C0, { 1600, 900,  { 60, 1 }, false } },
+    { 0xA940, { 1600, 1200, { 60, 1 }, false } },
+    { 0xA945, { 1600, 1200, { 65, 1 }, false } },
+    { 0xA94A, { 1600, 1200, { 70, 1 }, false } },
+    { 0xA94F, { 1600, 1200, { 75, 1 }, false } },
+    { 0xA959, { 1600, 1200, { 85, 1 }, false } },
+    { 0xB300, { 1680, 1050, { 60, 1 }, false } },
+    { 0xB30F, { 1680, 1050, { 75, 1 }, false } },
+    { 0xB319, { 1680, 1050, { 85, 1 }, false } },
+    { 0xC140, { 1792, 1344, { 60, 1 }, false } },
+    { 0xC14F, { 1792, 1344, { 75, 1 }, false } },
+    { 0xC940, { 1856, 1392, { 60, 1 }, false } },
+    { 0xC94F, { 1856, 1392, { 75, 1 }, false } },
+    { 0xD1C0, { 1920, 1080, { 60, 1 }, false } },
+    { 0xD100, { 1920, 1200, { 60, 1 }, false } },
+    { 0xD10F, { 1920, 1200, { 75, 1 }, false } },
+    { 0xD119, { 1920, 1200, { 85, 1 }, false } },
+    { 0xD140, { 1920, 1440, { 60, 1 }, false } },
+    { 0xD14F, { 1920, 1440, { 75, 1 }, false } },
+    { 0xE1C0, { 2048, 1152, { 60, 1 }, false } },
+  };
+
+#define STD_2_BYTE_CODE_HASH_BITS 7
+
+  // Perfect hash of the codes above, see the check of collisions below
+  constexpr size_t std_2_byte_code_hash(uint16_t code) {
+    return static_cast<uint16_t>(code * 2935) >> (16 - STD_2_BYTE_CODE_HASH_BITS);
+  }
+
+  // Index in std_2_byte_code_video_modes by the hash of a code, -1 for no code
+  inline constexpr auto std_2_byte_code_slots = [] {
+    std::array<int8_t, 1 << STD_2_BYTE_CODE_HASH_BITS> slots{};
+    for (auto& slot : slots)
+      slot = -1;
+    for (size_t i = 0; i < ARRAY_SIZE(std_2_byte_code_video_modes); ++i)
+      slots[std_2_byte_code_hash(std_2_byte_code_video_modes[i].code)] = i;
+    return slots;
+  }();
+
+  static_assert([] {
+    for (size_t i = 0; i < ARRAY_SIZE(std_2_byte_code_video_modes); ++i)
+      if (std_2_byte_code_slots[std_2_byte_code_hash(std_2_byte_code_video_modes[i].code)] != static_cast<int8_t>(i))
+        return false;
+    return true;
+  }(), "std_2_byte_code_hash has collisions");
+
+  constexpr int bit_position(uint8_t bit) {
+    int position = 0;
+    while (bit >>= 1)
+      ++position;
+    return position;
+  }
+
+  inline const VideoTimingMode& et_1_to_video_mode(EstablishedTiming1 et) {
+    return et_1_video_modes[bit_position(et)];
+  }
+
+  inline const VideoTimingMode& et_2_to_video_mode(EstablishedTiming2 et) {
+    return et_2_video_modes[bit_position(et)];
+  }
+
+  /** Video mode of the bit et of Manufacturer's Timings, nullptr for reserved bits */
+  inline const VideoTimingMode* mt_to_video_mode(ManufacturersTiming et) {
+    const VideoTimingMode& mode = mt_video_modes[bit_position(et)];
+    return mode.h_res != 0 ? &mode : nullptr;
+  }
+
+  /** Video mode of the bit et of byte i of Established Timings III, nullptr for reserved bits */
+  inline const VideoTimingMode* et_3_to_video_mode(int i, uint8_t et) {
+    const VideoTimingMode& mode = et_3_video_modes[i][bit_position(et)];
+    return mode.h_res != 0 ? &mode : nullptr;
+  }
+
+  /** Video mode of the Standard Timing code, nullptr for codes of non-DMT timings */
+  inline const VideoTimingMode* std_2_byte_code_to_video_mode(std::pair<uint8_t, uint8_t> std_2_byte_code) {
+    const uint16_t code = std_2_byte_code.first << 8 | std_2_byte_code.second;
+    const int8_t slot = std_2_byte_code_slots[std_2_byte_code_hash(code)];
+    if (slot < 0 || std_2_byte_code_video_modes[slot].code != code)
+      return nullptr;
+    return &std_2_byte_code_video_modes[slot].mode;
+  }
+
+  /** Looks the VIC up in the constant table of CTA-861 timings, nullptr for VICs 220-255 which are reserved */
+  const Cta861VideoTimingMode* get_cta861_video_timing_mode(uint8_t vic);
 
   VideoTimingMode to_video_timing_mode(const DetailedTimingDescriptor& dtd, uint8_t pixel_repetition_factor = 1);
+  /** Uses the lowest allowed pixel repetition factor */
+  VideoTimingMode to_video_timing_mode(const Cta861VideoTimingMode& mode);
 
   template <class Function>
   Function for_each_mode(const BaseBlock& base_block, Function fn) {
     for (EstablishedTiming1 et : bitfield_to_enums<EstablishedTiming1>(base_block.established_timings_1)) {
-      fn(et_1_to_video_mode.at(et));
+      fn(et_1_to_video_mode(et));
     }
     for (EstablishedTiming2 et : bitfield_to_enums<EstablishedTiming2>(base_block.established_timings_2)) {
-      fn(et_2_to_video_mode.at(et));
+      fn(et_2_to_video_mode(et));
     }
     for (ManufacturersTiming et : bitfield_to_enums<ManufacturersTiming>(base_block.manufacturers_timings)) {
-      fn(mt_to_video_mode.at(et));
+      if (const auto* mode = mt_to_video_mode(et))
+        fn(*mode);
     }
 
     for (const auto& standard_timing : base_block.standard_timings) {
       if (standard_timing.has_value()) {
-        const auto std_2_byte_code = generate_standard_timing(standard_timing);
-        if (std_2_byte_code_to_video_mode.count(std_2_byte_code) != 0) {
-          fn(std_2_byte_code_to_video_mode.at(std_2_byte_code));
+        if (const auto* mode = std_2_byte_code_to_video_mode(generate_standard_timing(standard_timing))) {
+          fn(*mode);
         }
       }
     }
@@ -193,7 +323,8 @@ namespace Edid {
         const auto& established_timings_3 = std::get<EstablishedTimings3>(descriptor);
         for (int i = 0; i < 6; ++i) {
           for (uint8_t et : bitfield_to_enums<EstablishedTiming3Byte6>(established_timings_3.bytes_6_11.at(i))) {
-            fn(et_3_to_video_mode.at({i, et}));
+            if (const auto* mode = et_3_to_video_mode(i, et))
+              fn(*mode);
           }
         }
       }
@@ -205,26 +336,26 @@ namespace Edid {
   template <class Function>
   void remove_mode_if(BaseBlock& base_block, Function fn, bool remove_unknown = false) {
     for (EstablishedTiming1 et : bitfield_to_enums<EstablishedTiming1>(base_block.established_timings_1)) {
-      if (fn(et_1_to_video_mode.at(et))) {
+      if (fn(et_1_to_video_mode(et))) {
         base_block.established_timings_1 &= ~et;
       }
     }
     for (EstablishedTiming2 et : bitfield_to_enums<EstablishedTiming2>(base_block.established_timings_2)) {
-      if (fn(et_2_to_video_mode.at(et))) {
+      if (fn(et_2_to_video_mode(et))) {
         base_block.established_timings_2 &= ~et;
       }
     }
     for (ManufacturersTiming et : bitfield_to_enums<ManufacturersTiming>(base_block.manufacturers_timings)) {
-      if (fn(mt_to_video_mode.at(et))) {
+      const auto* mode = mt_to_video_mode(et);
+      if (mode != nullptr && fn(*mode)) {
         base_block.manufacturers_timings &= ~et;
       }
     }
 
     for (auto& standard_timing : base_block.standard_timings) {
       if (standard_timing.has_value()) {
-        const auto std_2_byte_code = generate_standard_timing(standard_timing);
-        if (std_2_byte_code_to_video_mode.count(std_2_byte_code) != 0) {
-          if (fn(std_2_byte_code_to_video_mode.at(std_2_byte_code))) {
+        if (const auto* mode = std_2_byte_code_to_video_mode(generate_standard_timing(standard_timing))) {
+          if (fn(*mode)) {
             standard_timing = std::nullopt;
           }
         }
@@ -246,7 +377,8 @@ namespace Edid {
         auto& established_timings_3 = std::get<EstablishedTimings3>(descriptor);
         for (int i = 0; i < 6; ++i) {
           for (uint8_t et : bitfield_to_enums<EstablishedTiming3Byte6>(established_timings_3.bytes_6_11.at(i))) {
-            if (fn(et_3_to_video_mode.at({i, et}))) {
+            const auto* mode = et_3_to_video_mode(i, et);
+            if (mode != nullptr && fn(*mode)) {
               established_timings_3.bytes_6_11.at(i) &= ~et;
             }
           }
@@ -259,25 +391,9 @@ namespace Edid {
   Function for_each_mode(const Cta861Block& cta861_block, Function fn) {
     for (const auto& data_block : cta861_block.data_block_collection) {
       if (std::visit(is_vdb_visitor, data_block)) {
-        const auto& vics = std::get<VideoDataBlock>(data_block).vics;
-        for (const std::optional<uint8_t>& vic : vics) {
-          if (vic.has_value()) {
-            auto mode = get_cta861_video_timing_mode(vic.value());
-            if (mode.has_value()) {
-              uint8_t pixel_repetition_factor = 1;
-              if (std::holds_alternative<uint8_t>(mode->pixel_repetition_factor)) {
-                pixel_repetition_factor = std::get<uint8_t>(mode->pixel_repetition_factor);
-              }
-              else if (std::holds_alternative<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor)) {
-                pixel_repetition_factor = std::get<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor).first;
-              }
-              else if (std::holds_alternative<std::vector<uint8_t>>(mode->pixel_repetition_factor)) {
-                pixel_repetition_factor = std::get<std::vector<uint8_t>>(mode->pixel_repetition_factor).at(0);
-              }
-
-              fn(to_video_timing_mode(mode->dtd, pixel_repetition_factor));
-            }
-          }
+        for (uint8_t vic : std::get<VideoDataBlock>(data_block).vics) {
+          if (const auto* mode = get_cta861_video_timing_mode(vic))
+            fn(to_video_timing_mode(*mode));
         }
       }
       else if (std::visit(is_hdmi_vsdb_visitor, data_block)) {
@@ -285,21 +401,8 @@ namespace Edid {
         if (hdmi_vsdb.hdmi_video.has_value()) {
           for (uint8_t hdmi_vic : hdmi_vsdb.hdmi_video->hdmi_vics) {
             uint8_t vic = hdmi_vic_to_vic_map.at(hdmi_vic - 1);
-            auto mode = get_cta861_video_timing_mode(vic);
-            if (mode.has_value()) {
-              uint8_t pixel_repetition_factor = 1;
-              if (std::holds_alternative<uint8_t>(mode->pixel_repetition_factor)) {
-                pixel_repetition_factor = std::get<uint8_t>(mode->pixel_repetition_factor);
-              }
-              else if (std::holds_alternative<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor)) {
-                pixel_repetition_factor = std::get<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor).first;
-              }
-              else if (std::holds_alternative<std::vector<uint8_t>>(mode->pixel_repetition_factor)) {
-                pixel_repetition_factor = std::get<std::vector<uint8_t>>(mode->pixel_repetition_factor).at(0);
-              }
-
-              fn(to_video_timing_mode(mode->dtd, pixel_repetition_factor));
-            }
+            if (const auto* mode = get_cta861_video_timing_mode(vic))
+              fn(to_video_timing_mode(*mode));
           }
         }
       }
@@ -318,20 +421,8 @@ namespace Edid {
       if (std::visit(is_vdb_visitor, data_block)) {
         auto& vics = std::get<VideoDataBlock>(data_block).vics;
         for (auto it = vics.begin(); it != vics.end();) {
-          const auto mode = get_cta861_video_timing_mode(*it);
-          if (mode.has_value()) {
-            uint8_t pixel_repetition_factor = 1;
-            if (std::holds_alternative<uint8_t>(mode->pixel_repetition_factor)) {
-              pixel_repetition_factor = std::get<uint8_t>(mode->pixel_repetition_factor);
-            }
-            else if (std::holds_alternative<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor)) {
-              pixel_repetition_factor = std::get<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor).first;
-            }
-            else if (std::holds_alternative<std::vector<uint8_t>>(mode->pixel_repetition_factor)) {
-              pixel_repetition_factor = std::get<std::vector<uint8_t>>(mode->pixel_repetition_factor).at(0);
-            }
-
-            if (fn(to_video_timing_mode(mode->dtd, pixel_repetition_factor))) {
+          if (const auto* mode = get_cta861_video_timing_mode(*it)) {
+            if (fn(to_video_timing_mode(*mode))) {
               it = vics.erase(it);
               continue;
             }
@@ -352,20 +443,8 @@ namespace Edid {
             hdmi_vsdb.hdmi_video->hdmi_vics.end(),
             [remove_unknown, &fn](uint8_t hdmi_vic) {
               uint8_t vic = hdmi_vic_to_vic_map.at(hdmi_vic - 1);
-              auto mode = get_cta861_video_timing_mode(vic);
-              if (mode.has_value()) {
-                uint8_t pixel_repetition_factor = 1;
-                if (std::holds_alternative<uint8_t>(mode->pixel_repetition_factor)) {
-                  pixel_repetition_factor = std::get<uint8_t>(mode->pixel_repetition_factor);
-                }
-                else if (std::holds_alternative<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor)) {
-                  pixel_repetition_factor = std::get<std::pair<uint8_t, uint8_t>>(mode->pixel_repetition_factor).first;
-                }
-                else if (std::holds_alternative<std::vector<uint8_t>>(mode->pixel_repetition_factor)) {
-                  pixel_repetition_factor = std::get<std::vector<uint8_t>>(mode->pixel_repetition_factor).at(0);
-                }
-
-                if (fn(to_video_timing_mode(mode->dtd, pixel_repetition_factor))) {
+              if (const auto* mode = get_cta861_video_timing_mode(vic)) {
+                if (fn(to_video_timing_mode(*mode))) {
                   return true;
                 }
               }
@@ -413,4 +492,37 @@ namespace Edid {
       }
     }
   }
+
+  struct VideoTimingModeHash {
+    size_t operator()(const VideoTimingMode& mode) const;
+  };
+
+  /** Set of distinct video modes, e.g. the capabilities of a sink.
+   *  Rates are stored in the form of canonical_rate() so that the same mode reached via
+   *  a DTD, a VIC or an established timing is kept once. Modes without a rate, i.e. of DTDs
+   *  with zero horizontal or vertical totals, are skipped.
+   */
+  class ModeSet {
+   public:
+    using const_iterator = std::unordered_set<VideoTimingMode, VideoTimingModeHash>::const_iterator;
+
+    ModeSet() = default;
+    /** Collects the modes of the Base Block and every CTA-861 extension block */
+    explicit ModeSet(const EdidData& edid);
+
+    /** Returns false if the mode is already in the set or has a zero rate denominator */
+    bool insert(const VideoTimingMode& mode);
+    bool contains(const VideoTimingMode& mode) const;
+
+    size_t size() const { return modes_.size(); }
+    bool empty() const { return modes_.empty(); }
+    const_iterator begin() const { return modes_.begin(); }
+    const_iterator end() const { return modes_.end(); }
+
+    friend bool operator==(const ModeSet& lhs, const ModeSet& rhs) { return lhs.modes_ == rhs.modes_; }
+    friend bool operator!=(const ModeSet& lhs, const ModeSet& rhs) { return lhs.modes_ != rhs.modes_; }
+
+   private:
+    std::unordered_set<VideoTimingMode, VideoTimingModeHash> modes_;
+  };
 }  // namespace Edid
@@ -184,7 +184,12 @@ namespace Edid {
 
   std::array<uint8_t, EDID_BLOCK_SIZE> generate_base_block(const BaseBlock& base_block, uint8_t ext_blocks) {
     std::array<uint8_t, EDID_BLOCK_SIZE> result;
-    result.fill(0x0);
+    write_base_block(base_block, ext_blocks, result.data());
+    return result;
+  }
+
+  void write_base_block(const BaseBlock& base_block, uint8_t ext_blocks, uint8_t* result) {
+    std::fill_n(result, EDID_BLOCK_SIZE, 0x0);
     int pos = 0;
 
     // EDID header
@@ -276,7 +281,7 @@ namespace Edid {
     for (const auto& eighteen_byte_descriptor : base_block.eighteen_byte_descriptors) {
       const std::array<uint8_t, EIGHTEEN_BYTES> block =
         std::visit(eighteen_byte_descriptor_visitor, eighteen_byte_descriptor);
-      std::move(block.begin(), block.end(), result.begin() + pos);
+      std::copy(block.begin(), block.end(), result + pos);
       pos += block.size();
     }
 
@@ -285,8 +290,6 @@ namespace Edid {
 
     // Checksum
     result[pos] = calculate_block_checksum(result);
-
-    return result;
   }
 
   std::optional<StandardTiming> parse_standard_timing(uint8_t byte_1, uint8_t byte_2) {
@@ -338,13 +341,49 @@ namespace Edid {
     return DetailedTimingDescriptor::parse_byte_block(start);
   }
 
+  static bool is_known_display_descriptor_type(uint8_t display_descriptor_type) {
+    switch(display_descriptor_type) {
+      case BASE_DISPLAY_DESCRIPTOR_RANGE_LIMITS_TYPE:
+      case ASCII_DISPLAY_NAME:
+      case ASCII_UNSPECIFIED_TEXT:
+      case ASCII_SERIAL_NUMBER:
+      case BASE_DISPLAY_DESCRIPTOR_ESTABLISHED_TIMINGS_III_TYPE:
+      case BASE_DISPLAY_DESCRIPTOR_DUMMY_TYPE:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  std::optional<ParseError> check_base_block(const uint8_t* base_block) {
+    if (!std::equal(base_block_header.data(), base_block_header.data() + base_block_header.size(), base_block))
+      return ParseError{PE_INVALID_HEADER};
+
+    if (base_block[EDID_BLOCK_SIZE - 1] != calculate_block_checksum(base_block))
+      return ParseError{PE_INVALID_CHECKSUM, 0, EDID_BLOCK_SIZE - 1, base_block[EDID_BLOCK_SIZE - 1]};
+
+    const int descriptors_pos = 54;
+    for (int i = 0; i < BASE_18_BYTE_DESCRIPTORS; ++i) {
+      const uint8_t* start = base_block + descriptors_pos + i * EIGHTEEN_BYTES;
+      if (*start == 0x0 && *(start + 1) == 0x0 && *(start + 2) == 0x0 &&
+          !is_known_display_descriptor_type(*(start + 3)))
+        return ParseError{PE_UNKNOWN_DISPLAY_DESCRIPTOR, 0, static_cast<size_t>(start + 3 - base_block), *(start + 3)};
+    }
+
+    return std::nullopt;
+  }
+
   std::pair<BaseBlock, uint8_t> parse_base_block(const std::array<uint8_t, EDID_BLOCK_SIZE>& base_block) {
+    return parse_base_block(base_block.data());
+  }
+
+  std::pair<BaseBlock, uint8_t> parse_base_block(const uint8_t* base_block) {
     BaseBlock result_struct;
     uint8_t result_ext_blocks = 0;
     int pos = 0;
 
     // EDID header
-    if (!std::equal(base_block_header.data(), base_block_header.data() + base_block_header.size(), base_block.data())) {
+    if (!std::equal(base_block_header.data(), base_block_header.data() + base_block_header.size(), base_block)) {
       throw EdidException(__FUNCTION__, "EDID base block header is invalid.");
     }
     pos += base_block_header.size();
@@ -407,7 +446,7 @@ namespace Edid {
 
     // Chromaticity coordinates
     {
-      const auto& start = base_block.data() + pos + 1;
+      const auto& start = base_block + pos + 1;
       std::copy(start, start + result_struct.chromaticity.size(), result_struct.chromaticity.data());
       pos += result_struct.chromaticity.size();
     }
@@ -429,7 +468,7 @@ namespace Edid {
     }
 
     for (int i = 0; i < BASE_18_BYTE_DESCRIPTORS; ++i) {
-      result_struct.eighteen_byte_descriptors[i] = parse_byte_block(base_block.data() + pos);
+      result_struct.eighteen_byte_descriptors[i] = parse_byte_block(base_block + pos);
       pos += EIGHTEEN_BYTES;
     }
 
@@ -1,23 +1,22 @@
 // Copyright 2023 N-Nagorny
-#include <unordered_set>
-
 #include "edid/bcp00501.hh"
 #include "edid/timing_modes.hh"
 
 using json = nlohmann::json;
 
 namespace Edid {
-  json generate_constraint_set(const VideoTimingMode& mode) {
-    const std::string cap_frame_width = "urn:x-nmos:cap:format:frame_width";
-    const std::string cap_frame_height = "urn:x-nmos:cap:format:frame_height";
-    const std::string cap_grain_rate = "urn:x-nmos:cap:format:grain_rate";
-    const std::string cap_interlace_mode = "urn:x-nmos:cap:format:interlace_mode";
+  // Keys and values of BCP-005-01 constraint sets
+  constexpr const char* cap_frame_width = "urn:x-nmos:cap:format:frame_width";
+  constexpr const char* cap_frame_height = "urn:x-nmos:cap:format:frame_height";
+  constexpr const char* cap_grain_rate = "urn:x-nmos:cap:format:grain_rate";
+  constexpr const char* cap_interlace_mode = "urn:x-nmos:cap:format:interlace_mode";
 
-    const std::string interlaced_bff = "interlaced_bff";
-    const std::string interlaced_tff = "interlaced_tff";
-    const std::string interlaced_psf = "interlaced_psf";
-    const std::string progressive = "progressive";
+  constexpr const char* interlaced_bff = "interlaced_bff";
+  constexpr const char* interlaced_tff = "interlaced_tff";
+  constexpr const char* interlaced_psf = "interlaced_psf";
+  constexpr const char* progressive = "progressive";
 
+  json generate_constraint_set(const VideoTimingMode& mode) {
     json result;
 
     result[cap_frame_width]["enum"] = { mode.h_res };
@@ -54,25 +53,14 @@ namespace Edid {
     return result;
   }
 
-  template <class Block>
-  std::unordered_set<json> generate_constraint_sets(const Block& block) {
-    std::unordered_set<json> result;
-
-    for_each_mode(block, [&result](const VideoTimingMode& mode) {
-      result.insert(generate_constraint_set(mode));
-    });
+  json generate_constraint_sets(const EdidData& edid) {
+    // Deduplicate on typed modes first so that JSON is built once per distinct mode
+    const ModeSet modes(edid);
 
+    json result = json::array();
+    result.get_ref<json::array_t&>().reserve(modes.size());
+    for (const VideoTimingMode& mode : modes)
+      result.push_back(generate_constraint_set(mode));
     return result;
   }
-
-  json generate_constraint_sets(const EdidData& edid) {
-    std::unordered_set<json> constraint_sets = generate_constraint_sets(edid.base_block);
-    if (edid.extension_blocks.has_value()) {
-      for (const auto& ext_block : edid.extension_blocks.value()) {
-        std::unordered_set<json> temp = generate_constraint_sets(ext_block);
-        std::move(temp.begin(), temp.end(), std::inserter(constraint_sets, constraint_sets.end()));
-      }
-    }
-    return json(constraint_sets);
-  }
 }  // namespace Edid
@@ -1,49 +1,100 @@
 // Copyright 2023 N-Nagorny
 #include <array>
 #include <cstdint>
-#include <fstream>
 #include <iostream>
 
 #include "edid/common.hh"
 #include "edid/dtd.hh"
 #include "edid/eighteen_byte_descriptors.hh"
-#include "edid/filesystem.hh"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define EDID_X86_CHECKSUM
+#include <immintrin.h>
+#endif
 
 namespace Edid {
   uint8_t calculate_block_checksum(const std::array<uint8_t, EDID_BLOCK_SIZE>& block) {
-    int sum = 0;
-    for (int i = 0; i < EDID_BLOCK_SIZE - 1; ++i)
-      sum += block.at(i);
-    return 256 - sum % 256;
+    return calculate_block_checksum(block.data());
   }
 
-  std::vector<uint8_t> read_file(const std::string& file_path) {
-    using namespace std;
+  namespace {
+    // Each kernel returns the sum of all EDID_BLOCK_SIZE bytes of the block
+    uint32_t block_sum_scalar(const uint8_t* block) {
+      uint32_t sum = 0;
+      for (int i = 0; i < EDID_BLOCK_SIZE; ++i)
+        sum += block[i];
+      return sum;
+    }
 
-    if (!filesystem::is_regular_file(file_path))
-      throw runtime_error(file_path + " is not a regular file");
+#ifdef EDID_X86_CHECKSUM
+    __attribute__((target("sse2")))
+    uint32_t block_sum_sse2(const uint8_t* block) {
+      const __m128i zero = _mm_setzero_si128();
+      __m128i sum = zero;
+      for (int i = 0; i < EDID_BLOCK_SIZE; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(bytes, zero));
+      }
+      return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+    }
 
-    ifstream file(file_path,
-      ios_base::in | ios_base::binary
-    );
-    file.exceptions(ifstream::eofbit | ifstream::failbit | ifstream::badbit);
+    __attribute__((target("avx2")))
+    uint32_t block_sum_avx2(const uint8_t* block) {
+      const __m256i zero = _mm256_setzero_si256();
+      __m256i sum = zero;
+      for (int i = 0; i < EDID_BLOCK_SIZE; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(bytes, zero));
+      }
+      const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+      return _mm_cvtsi128_si32(half) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(half, half));
+    }
+#endif
 
-    // Stop eating new lines in binary mode!!!
-    file.unsetf(ios::skipws);
+    using BlockSum = uint32_t (*)(const uint8_t*);
 
-    // get its size
-    streampos file_size;
+    BlockSum select_block_sum() {
+#ifdef EDID_X86_CHECKSUM
+      // Runs at first use, possibly from static initialisation before the CPU model is set up
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return block_sum_avx2;
+      if (__builtin_cpu_supports("sse2"))
+        return block_sum_sse2;
+#endif
+      return block_sum_scalar;
+    }
 
-    file.seekg(0, ios::end);
-    file_size = file.tellg();
-    file.seekg(0, ios::beg);
+    // Function-local so that checksums computed by static initializers of other translation units
+    // don't call through the pointer before it's set
+    uint32_t block_sum(const uint8_t* block) {
+      static const BlockSum selected = select_block_sum();
+      return selected(block);
+    }
+  }  // namespace
 
-    // reserve capacity
-    vector<uint8_t> vec(file_size);
+  uint8_t calculate_block_checksum(const uint8_t* block) {
+    return 256 - (block_sum(block) - block[EDID_BLOCK_SIZE - 1]) % 256;
+  }
 
-    // read the data
-    file.read(reinterpret_cast<char*>(vec.data()), file_size);
+  size_t verify_checksums(const uint8_t* blocks, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      if (block_sum(blocks + i * EDID_BLOCK_SIZE) % 256 != 0)
+        return i;
+    }
+    return count;
+  }
 
-    return vec;
+  size_t repair_checksums(uint8_t* blocks, size_t count) {
+    size_t repaired = 0;
+    for (size_t i = 0; i < count; ++i) {
+      uint8_t* block = blocks + i * EDID_BLOCK_SIZE;
+      const uint8_t remainder = block_sum(block) % 256;
+      if (remainder != 0) {
+        block[EDID_BLOCK_SIZE - 1] -= remainder;
+        ++repaired;
+      }
+    }
+    return repaired;
   }
 }  // namespace Edid
@@ -1,52 +1,49 @@
 // Copyright 2023 N-Nagorny
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <iostream>
-#include <numeric>
 
 #include "edid/common.hh"
 #include "edid/cta861_block.hh"
 
 namespace Edid {
   std::vector<uint8_t> generate_data_block_collection(const DataBlockCollection& collection) {
-    size_t collection_size = std::accumulate(collection.begin(), collection.end(), 0, [](size_t size, const CtaDataBlock& data_block) {
-      return size + std::visit(get_cta_data_block_size, data_block);
-    });
+    size_t collection_size = 0;
+    for (const auto& data_block : collection)
+      collection_size += std::visit(get_cta_data_block_size, data_block);
+
     std::vector<uint8_t> result(collection_size, 0x0);
-    auto pos = result.begin();
+    write_data_block_collection(collection, result.data());
+    return result;
+  }
 
+  uint8_t* write_data_block_collection(const DataBlockCollection& collection, uint8_t* out) {
     for (const auto& data_block : collection) {
-      auto cta_data_block_visitor =
-        [](const auto& cta_data_block) -> std::vector<uint8_t> {
-          return cta_data_block.generate_byte_block();
-        };
-
-      std::vector<uint8_t> byte_block = std::visit(cta_data_block_visitor, data_block);
-      pos = std::move(byte_block.begin(), byte_block.end(), pos);
+      out = std::visit([out](const auto& cta_data_block) {
+        return cta_data_block.write_byte_block(out);
+      }, data_block);
     }
+    return out;
+  }
 
+  std::array<uint8_t, EDID_BLOCK_SIZE> generate_cta861_block(const Cta861Block& cta861) {
+    std::array<uint8_t, EDID_BLOCK_SIZE> result;
+    write_cta861_block(cta861, result.data());
     return result;
   }
 
-  std::array<uint8_t, EDID_BLOCK_SIZE> generate_cta861_block(const Cta861Block& cta861) {
+  void write_cta861_block(const Cta861Block& cta861, uint8_t* result) {
     const int header_size = 4;
     const int checksum_size = 1;
     const int dtd_block_size = cta861.detailed_timing_descriptors.size() * EIGHTEEN_BYTES;
-    const int data_block_collection_size = std::accumulate(cta861.data_block_collection.begin(), cta861.data_block_collection.end(), 0, [](size_t size, const CtaDataBlock& data_block) {
-      return size + std::visit(get_cta_data_block_size, data_block);
-    });
-    const int native_video_modes = std::accumulate(cta861.data_block_collection.begin(), cta861.data_block_collection.end(), 0, [](size_t size, const CtaDataBlock& data_block) {
-      if (std::visit(is_vdb_visitor, data_block)) {
-        const VideoDataBlock vdb = std::visit(
-            [](auto const & val)
-            { if constexpr ( std::is_convertible_v<decltype(val), VideoDataBlock> )
-                 return VideoDataBlock(val);
-               else
-                { throw std::bad_variant_access{}; return VideoDataBlock{}; } }, data_block);
-        return size + vdb.native_vics();
-      }
-      return size;
-    });
+    int data_block_collection_size = 0;
+    int native_video_modes = 0;
+    for (const auto& data_block : cta861.data_block_collection) {
+      data_block_collection_size += std::visit(get_cta_data_block_size, data_block);
+      if (const auto* vdb = std::get_if<VideoDataBlock>(&data_block))
+        native_video_modes += vdb->native_vics();
+    }
 
     if (header_size + data_block_collection_size + dtd_block_size + checksum_size > EDID_BLOCK_SIZE)
       throw EdidException(__FUNCTION__,
@@ -56,8 +53,6 @@ namespace Edid {
         " checksum (" + std::to_string(checksum_size) + " B)"
         " take more than " + std::to_string(EDID_BLOCK_SIZE) + " B.");
 
-    std::array<uint8_t, EDID_BLOCK_SIZE> result;
-    result.fill(0x0);
     int pos = 0;
 
     // Header
@@ -76,13 +71,12 @@ namespace Edid {
     result[pos] |= cta861.ycbcr_422 << 4;
     result[pos++] |= native_video_modes & BITMASK_TRUE(4);
 
-    std::vector<uint8_t> data_block_collection = generate_data_block_collection(cta861.data_block_collection);
-    std::move(data_block_collection.begin(), data_block_collection.end(), result.begin() + pos);
+    write_data_block_collection(cta861.data_block_collection, result + pos);
     pos += data_block_collection_size;
 
     for (const auto& detailed_timing_descriptor : cta861.detailed_timing_descriptors) {
       auto dtd = detailed_timing_descriptor.generate_byte_block();
-      std::move(dtd.begin(), dtd.end(), result.begin() + pos);
+      std::copy(dtd.begin(), dtd.end(), result + pos);
       pos += dtd.size();
     }
 
@@ -90,83 +84,162 @@ namespace Edid {
       result[pos++] = 0x0;
 
     result[pos] = calculate_block_checksum(result);
-
-    return result;
   }
 
-  std::unique_ptr<CtaDataBlock> parse_extended_tag_data_block(const uint8_t* iter_read) {
-    std::unique_ptr<CtaDataBlock> data_block_ptr = nullptr;
-
+  CtaDataBlock& parse_extended_tag_data_block(DataBlockCollection& collection, const uint8_t* iter_read, std::pmr::memory_resource* resource) {
     uint8_t extended_tag = *(iter_read + 1);
     switch (extended_tag) {
       case CTA861_EXTENDED_YCBCR420_CAPABILITY_MAP_DATA_BLOCK_TAG:
-        data_block_ptr = std::make_unique<CtaDataBlock>(std::move(YCbCr420CapabilityMapDataBlock::parse_byte_block(iter_read)));
-        break;
+        return collection.emplace_back(YCbCr420CapabilityMapDataBlock::parse_byte_block(iter_read));
       case CTA861_EXTENDED_COLORIMETRY_BLOCK_TAG:
-        data_block_ptr = std::make_unique<CtaDataBlock>(std::move(ColorimetryDataBlock::parse_byte_block(iter_read)));
-        break;
+        return collection.emplace_back(ColorimetryDataBlock::parse_byte_block(iter_read));
       case CTA861_EXTENDED_HDR_STATIC_METADATA_BLOCK_TAG:
-        data_block_ptr = std::make_unique<CtaDataBlock>(std::move(HdrStaticMetadataDataBlock::parse_byte_block(iter_read)));
-        break;
+        return collection.emplace_back(HdrStaticMetadataDataBlock::parse_byte_block(iter_read));
       case CTA861_EXTENDED_VIDEO_CAPABILITY_BLOCK_TAG:
-        data_block_ptr = std::make_unique<CtaDataBlock>(std::move(VideoCapabilityDataBlock::parse_byte_block(iter_read)));
-        break;
+        return collection.emplace_back(VideoCapabilityDataBlock::parse_byte_block(iter_read));
       default:
-        data_block_ptr = std::make_unique<CtaDataBlock>(std::move(UnknownDataBlock::parse_byte_block(iter_read)));
+        return collection.emplace_back(UnknownDataBlock::parse_byte_block(iter_read, resource));
     }
-    return data_block_ptr;
   }
 
-  std::unique_ptr<CtaDataBlock> parse_vendor_specific_data_block(const uint8_t* iter_read) {
-    std::unique_ptr<CtaDataBlock> data_block_ptr = nullptr;
-
-    const std::array<uint8_t, 3> oui = {*(iter_read + 1), *(iter_read + 2), *(iter_read + 3)};
-    if (oui == hdmi_oui_little_endian) {
-      data_block_ptr = std::make_unique<CtaDataBlock>(std::move(HdmiVendorDataBlock::parse_byte_block(iter_read)));
-    }
-    else {
-      data_block_ptr = std::make_unique<CtaDataBlock>(std::move(UnknownDataBlock::parse_byte_block(iter_read)));
-    }
-    return data_block_ptr;
+  CtaDataBlock& parse_vendor_specific_data_block(DataBlockCollection& collection, const uint8_t* iter_read, std::pmr::memory_resource* resource) {
+    if (std::equal(hdmi_oui_little_endian.begin(), hdmi_oui_little_endian.end(), iter_read + 1))
+      return collection.emplace_back(HdmiVendorDataBlock::parse_byte_block(iter_read, resource));
+    return collection.emplace_back(UnknownDataBlock::parse_byte_block(iter_read, resource));
   }
 
   DataBlockCollection parse_data_block_collection(const std::vector<uint8_t>& collection) {
-    DataBlockCollection result;
-    auto iter_read = collection.data();
-    std::unique_ptr<CtaDataBlock> data_block_ptr = nullptr;
+    return parse_data_block_collection(collection.data(), collection.size());
+  }
+
+  DataBlockCollection parse_data_block_collection(const uint8_t* collection, size_t size, std::pmr::memory_resource* resource) {
+    const uint8_t* const end = collection + size;
+
+    // Data Block headers carry their lengths, so the number of blocks is known upfront
+    size_t data_blocks = 0;
+    for (auto iter_read = collection; iter_read < end; iter_read += 1 + (*iter_read & BITMASK_TRUE(5)))
+      ++data_blocks;
 
-    while (iter_read < collection.data() + collection.size()) {
+    DataBlockCollection result(resource);
+    result.reserve(data_blocks);
+    auto iter_read = collection;
+
+    while (iter_read < end) {
+      if (iter_read + 1 + (*iter_read & BITMASK_TRUE(5)) > end)
+        throw EdidException(__FUNCTION__, "Data Block runs past the end of Data Block Collection");
       uint8_t data_block_tag = *iter_read >> 5 & BITMASK_TRUE(3);
+      CtaDataBlock* data_block = nullptr;
       switch (data_block_tag) {
         case CTA861_VIDEO_DATA_BLOCK_TAG:
-          data_block_ptr = std::make_unique<CtaDataBlock>(std::move(VideoDataBlock::parse_byte_block(iter_read)));
+          data_block = &result.emplace_back(VideoDataBlock::parse_byte_block(iter_read, resource));
           break;
         case CTA861_AUDIO_DATA_BLOCK_TAG:
-          data_block_ptr = std::make_unique<CtaDataBlock>(std::move(AudioDataBlock::parse_byte_block(iter_read)));
+          data_block = &result.emplace_back(AudioDataBlock::parse_byte_block(iter_read, resource));
           break;
         case CTA861_SPEAKERS_DATA_BLOCK_TAG:
-          data_block_ptr = std::make_unique<CtaDataBlock>(std::move(SpeakerAllocationDataBlock::parse_byte_block(iter_read)));
+          data_block = &result.emplace_back(SpeakerAllocationDataBlock::parse_byte_block(iter_read));
           break;
         case CTA861_EXTENDED_TAG:
-          data_block_ptr = parse_extended_tag_data_block(iter_read);
+          data_block = &parse_extended_tag_data_block(result, iter_read, resource);
           break;
         case CTA861_VENDOR_DATA_BLOCK_TAG:
-          data_block_ptr = parse_vendor_specific_data_block(iter_read);
+          data_block = &parse_vendor_specific_data_block(result, iter_read, resource);
           break;
         default:
-          data_block_ptr = std::make_unique<CtaDataBlock>(std::move(UnknownDataBlock::parse_byte_block(iter_read)));
+          data_block = &result.emplace_back(UnknownDataBlock::parse_byte_block(iter_read, resource));
       }
       iter_read += std::visit([](const auto& data_block) {
         return data_block.size();
-      }, *data_block_ptr);
-      result.push_back(*data_block_ptr);
+      }, *data_block);
     }
 
     return result;
   }
 
+  static std::optional<ParseError> check_data_block(const uint8_t* data_block) {
+    const uint8_t data_block_tag = *data_block >> 5 & BITMASK_TRUE(3);
+    const uint8_t length = *data_block & BITMASK_TRUE(5);
+    bool is_valid = true;
+
+    switch (data_block_tag) {
+      case CTA861_AUDIO_DATA_BLOCK_TAG:
+        is_valid = length % ShortAudioDescriptor::size() == 0;
+        break;
+      case CTA861_SPEAKERS_DATA_BLOCK_TAG:
+        is_valid = length == CTA861_SPEAKERS_DATA_BLOCK_LENGTH;
+        break;
+      case CTA861_EXTENDED_TAG:
+        if (length < CTA861_EXTENDED_TAG_SIZE) {
+          is_valid = false;
+          break;
+        }
+        switch (data_block[1]) {
+          case CTA861_EXTENDED_COLORIMETRY_BLOCK_TAG:
+            is_valid = length == CTA861_COLORIMETRY_DATA_BLOCK_LENGTH;
+            break;
+          case CTA861_EXTENDED_HDR_STATIC_METADATA_BLOCK_TAG:
+            is_valid = length >= CTA861_HDR_STATIC_METADATA_DATA_BLOCK_MIN_LENGTH &&
+              length <= CTA861_HDR_STATIC_METADATA_DATA_BLOCK_MAX_LENGTH;
+            break;
+          case CTA861_EXTENDED_VIDEO_CAPABILITY_BLOCK_TAG:
+            is_valid = length == CTA861_VIDEO_CAPABILITY_DATA_BLOCK_LENGTH;
+            break;
+        }
+        break;
+      case CTA861_VENDOR_DATA_BLOCK_TAG:
+        if (!std::equal(hdmi_oui_little_endian.begin(), hdmi_oui_little_endian.end(), data_block + 1))
+          break;
+        is_valid = length >= 5 && length != 9;
+        // Latency, Interlaced Latency and HDMI Video fields
+        if (length >= 8 && (data_block[8] >> 5 & BITMASK_TRUE(3)) != 0)
+          is_valid = is_valid && length >= 10;
+        break;
+    }
+
+    if (!is_valid)
+      return ParseError{PE_INVALID_DATA_BLOCK_LENGTH, 0, 0, length};
+    return std::nullopt;
+  }
+
+  std::optional<ParseError> check_cta861_block(const uint8_t* cta861) {
+    if (cta861[0] != CTA861_EXT_TAG)
+      return ParseError{PE_INVALID_EXTENSION_TAG, 0, 0, cta861[0]};
+    if (cta861[1] != CTA861_VERSION)
+      return ParseError{PE_UNSUPPORTED_EXTENSION_VERSION, 0, 1, cta861[1]};
+    if (cta861[EDID_BLOCK_SIZE - 1] != calculate_block_checksum(cta861))
+      return ParseError{PE_INVALID_CHECKSUM, 0, EDID_BLOCK_SIZE - 1, cta861[EDID_BLOCK_SIZE - 1]};
+
+    const int dtd_start_pos = cta861[2];
+    if (dtd_start_pos != 0 && (dtd_start_pos < 4 || dtd_start_pos >= EDID_BLOCK_SIZE - 1))
+      return ParseError{PE_INVALID_DTD_OFFSET, 0, 2, cta861[2]};
+
+    for (int pos = 4; pos < dtd_start_pos; pos += 1 + (cta861[pos] & BITMASK_TRUE(5))) {
+      // The last Data Block must end before the DTDs
+      if (pos + 1 + (cta861[pos] & BITMASK_TRUE(5)) > dtd_start_pos)
+        return ParseError{PE_DATA_BLOCK_OVERRUN, 0, 2, cta861[2]};
+      if (auto error = check_data_block(cta861 + pos)) {
+        error->byte_offset = pos;
+        return error;
+      }
+    }
+
+    // DTDs are read until padding and must end before the checksum
+    if (dtd_start_pos != 0) {
+      for (int pos = dtd_start_pos; pos + 1 < EDID_BLOCK_SIZE - 1 && cta861[pos] != 0 && cta861[pos + 1] != 0; pos += EIGHTEEN_BYTES) {
+        if (pos + EIGHTEEN_BYTES > EDID_BLOCK_SIZE - 1)
+          return ParseError{PE_INVALID_DTD_OFFSET, 0, 2, cta861[2]};
+      }
+    }
+
+    return std::nullopt;
+  }
+
   Cta861Block parse_cta861_block(const std::array<uint8_t, EDID_BLOCK_SIZE>& cta861) {
-    Cta861Block result;
+    return parse_cta861_block(cta861.data());
+  }
+
+  Cta861Block parse_cta861_block(const uint8_t* cta861, std::pmr::memory_resource* resource) {
+    Cta861Block result(resource);
     int pos = 0;
 
     // Header
@@ -183,6 +256,9 @@ namespace Edid {
       throw EdidException(__FUNCTION__, "CTA Extension checksum is invalid.");
 
     int dtd_start_pos = cta861[++pos];
+    if (dtd_start_pos != 0 && (dtd_start_pos < pos + 2 || dtd_start_pos >= EDID_BLOCK_SIZE - 1))
+      throw EdidException(__FUNCTION__, "CTA Extension has invalid DTD offset: " +
+        std::to_string(dtd_start_pos));
 
     result.underscan = cta861[++pos] >> 7 & BITMASK_TRUE(1);
     result.basic_audio = cta861[pos] >> 6 & BITMASK_TRUE(1);
@@ -191,16 +267,17 @@ namespace Edid {
 
     if (dtd_start_pos != 0) {
       if (dtd_start_pos != pos) {
-        result.data_block_collection = parse_data_block_collection(std::vector<uint8_t>(
-          cta861.begin() + pos,
-          cta861.begin() + dtd_start_pos
-        ));
+        result.data_block_collection = parse_data_block_collection(cta861 + pos, dtd_start_pos - pos, resource);
         pos = dtd_start_pos;
       }
 
+      result.detailed_timing_descriptors.reserve((EDID_BLOCK_SIZE - 1 - pos) / EIGHTEEN_BYTES);
       // While not Beginning of Padding or Checksum (Table 60)
-      while (cta861[pos] != 0 && cta861[pos + 1] != 0 && pos + 1 < EDID_BLOCK_SIZE - 1) {
-        result.detailed_timing_descriptors.push_back(DetailedTimingDescriptor::parse_byte_block(cta861.begin() + pos));
+      while (pos + 1 < EDID_BLOCK_SIZE - 1 && cta861[pos] != 0 && cta861[pos + 1] != 0) {
+        if (pos + EIGHTEEN_BYTES > EDID_BLOCK_SIZE - 1)
+          throw EdidException(__FUNCTION__, "CTA Extension DTD at byte " + std::to_string(pos) +
+            " runs into the checksum");
+        result.detailed_timing_descriptors.push_back(DetailedTimingDescriptor::parse_byte_block(cta861 + pos));
         pos += EIGHTEEN_BYTES;
       }
     }
@@ -2,8 +2,8 @@
 #include "edid/cta_data_block.hh"
 
 namespace Edid {
-  std::vector<uint8_t> UnknownDataBlock::generate_byte_block() const {
-    std::vector<uint8_t> result(size(), 0x00);
+  uint8_t* UnknownDataBlock::write_byte_block(uint8_t* result) const {
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = (data_block_tag & BITMASK_TRUE(3)) << 5;
@@ -12,9 +12,9 @@ namespace Edid {
       result[pos++] = extended_tag.value();
     }
 
-    std::copy(raw_data.begin(), raw_data.end(), result.begin() + pos);
+    std::copy(raw_data.begin(), raw_data.end(), result + pos);
 
-    return result;
+    return result + size();
   }
 
   void UnknownDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -25,7 +25,7 @@ namespace Edid {
       std::dec << '\n';
   }
 
-  std::vector<uint8_t> VideoDataBlock::generate_byte_block() const {
+  uint8_t* VideoDataBlock::write_byte_block(uint8_t* result) const {
     // Note that data blocks with CTA Tag Codes of 1 through 6
     // are limited to containing 31 payload bytes
     //
@@ -35,15 +35,15 @@ namespace Edid {
         vics.size()
       );
 
-    std::vector<uint8_t> result(size(), 0x0);
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_VIDEO_DATA_BLOCK_TAG << 5;
     result[pos++] |= vics.size() & BITMASK_TRUE(5);
 
-    std::copy(vics.data(), vics.data() + vics.size(), result.data() + pos);
+    std::copy(vics.data(), vics.data() + vics.size(), result + pos);
 
-    return result;
+    return result + size();
   }
 
   void VideoDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -56,7 +56,7 @@ namespace Edid {
       os << indent << static_cast<int>(vic) << "\n";
   }
 
-  std::vector<uint8_t> AudioDataBlock::generate_byte_block() const {
+  uint8_t* AudioDataBlock::write_byte_block(uint8_t* result) const {
     // Each Short Audio Descriptor is 3-bytes long. There can be up to 31 bytes of payload in a Data
     // Block, therefore there may be up to 10 Short Audio Descriptors
     //
@@ -66,7 +66,7 @@ namespace Edid {
         sads.size()
       );
 
-    std::vector<uint8_t> result(size(), 0x0);
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_AUDIO_DATA_BLOCK_TAG << 5;
@@ -79,7 +79,7 @@ namespace Edid {
       result[pos++] = sad.lpcm_bit_depths;
     }
 
-    return result;
+    return result + size();
   }
 
   void AudioDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -99,8 +99,8 @@ namespace Edid {
     os << '\n';
   }
 
-  std::vector<uint8_t> SpeakerAllocationDataBlock::generate_byte_block() const {
-    std::vector<uint8_t> result(size(), 0x00);
+  uint8_t* SpeakerAllocationDataBlock::write_byte_block(uint8_t* result) const {
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_SPEAKERS_DATA_BLOCK_TAG << 5;
@@ -110,7 +110,7 @@ namespace Edid {
     result[pos++] = 0;
     result[pos] = 0;
 
-    return result;
+    return result + size();
   }
 
   void SpeakerAllocationDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -120,8 +120,8 @@ namespace Edid {
     os << '\n';
   }
 
-  std::vector<uint8_t> YCbCr420CapabilityMapDataBlock::generate_byte_block() const {
-    std::vector<uint8_t> result(size(), 0x00);
+  uint8_t* YCbCr420CapabilityMapDataBlock::write_byte_block(uint8_t* result) const {
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_EXTENDED_TAG << 5;
@@ -134,7 +134,7 @@ namespace Edid {
       result[pos + byte_index] |= BITMASK_TRUE(1) << bit_index;
     }
 
-    return result;
+    return result + size();
   }
 
   void YCbCr420CapabilityMapDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -144,8 +144,8 @@ namespace Edid {
     os << '\n';
   }
 
-  std::vector<uint8_t> ColorimetryDataBlock::generate_byte_block() const {
-    std::vector<uint8_t> result(size(), 0x00);
+  uint8_t* ColorimetryDataBlock::write_byte_block(uint8_t* result) const {
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_EXTENDED_TAG << 5;
@@ -156,7 +156,7 @@ namespace Edid {
     result[pos] = (colorimetry_standards >> 12 & BITMASK_TRUE(4)) << 4;
     result[pos] |= gamut_metadata_profiles & BITMASK_TRUE(4);
 
-    return result;
+    return result + size();
   }
 
   void ColorimetryDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -181,6 +181,10 @@ namespace Edid {
       throw EdidException(__FUNCTION__, "Extended Tag Data Block has incorrect Data Block Tag: " +
         std::to_string(data_block_tag)
       );
+    if (size_remainder < CTA861_HDR_STATIC_METADATA_DATA_BLOCK_MIN_LENGTH ||
+        size_remainder > CTA861_HDR_STATIC_METADATA_DATA_BLOCK_MAX_LENGTH)
+      throw EdidException(__FUNCTION__, "HDR Static Metadata Data Block has invalid length: " +
+        std::to_string(size_remainder));
 
     int extended_tag = *iter++; size_remainder--;
     if (extended_tag != CTA861_EXTENDED_HDR_STATIC_METADATA_BLOCK_TAG)
@@ -204,8 +208,8 @@ namespace Edid {
     return result;
   }
 
-  std::vector<uint8_t> HdrStaticMetadataDataBlock::generate_byte_block() const {
-    std::vector<uint8_t> result(size(), 0x00);
+  uint8_t* HdrStaticMetadataDataBlock::write_byte_block(uint8_t* result) const {
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_EXTENDED_TAG << 5;
@@ -229,7 +233,7 @@ namespace Edid {
       result[pos] = *min_luminance_code_value;
     }
 
-    return result;
+    return result + size();
   }
 
   void HdrStaticMetadataDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -275,12 +279,17 @@ namespace Edid {
   VideoCapabilityDataBlock VideoCapabilityDataBlock::parse_byte_block(const uint8_t* iter) {
     VideoCapabilityDataBlock result;
 
-    const uint8_t data_block_tag = *iter++ >> 5 & BITMASK_TRUE(3);
+    const uint8_t data_block_tag = *iter >> 5 & BITMASK_TRUE(3);
     if (data_block_tag != CTA861_EXTENDED_TAG)
       throw EdidException(__FUNCTION__, "Extended Tag Data Block has incorrect Data Block Tag: " +
         std::to_string(data_block_tag)
       );
 
+    const uint8_t length = *iter++ & BITMASK_TRUE(5);
+    if (length != CTA861_VIDEO_CAPABILITY_DATA_BLOCK_LENGTH)
+      throw EdidException(__FUNCTION__, "Video Capability Data Block has invalid length: " +
+        std::to_string(length));
+
     int extended_tag = *iter++;
     if (extended_tag != CTA861_EXTENDED_VIDEO_CAPABILITY_BLOCK_TAG)
       throw EdidException(__FUNCTION__, "Video Capability Data Block has incorrect Extended Data Block Tag: " +
@@ -296,8 +305,8 @@ namespace Edid {
     return result;
   }
 
-  std::vector<uint8_t> VideoCapabilityDataBlock::generate_byte_block() const {
-    std::vector<uint8_t> result(size(), 0x00);
+  uint8_t* VideoCapabilityDataBlock::write_byte_block(uint8_t* result) const {
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_EXTENDED_TAG << 5;
@@ -310,7 +319,7 @@ namespace Edid {
     result[pos] |= (it_scan_behaviour & BITMASK_TRUE(2)) << 2;
     result[pos] |= ce_scan_behaviour & BITMASK_TRUE(2);
 
-    return result;
+    return result + size();
   }
 
   void VideoCapabilityDataBlock::print(std::ostream& os, uint8_t tabs) const {
@@ -1,7 +1,13 @@
 // Copyright 2023 N-Nagorny
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <exception>
 #include <iostream>
+#include <new>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 #include "edid/base_block.hh"
@@ -11,46 +17,237 @@
 
 namespace Edid {
   std::vector<uint8_t> generate_edid_binary(const EdidData& edid) {
-    int ext_blocks = edid.extension_blocks.value_or(std::vector<Cta861Block>{}).size();
-    size_t edid_size = (ext_blocks + 1) * EDID_BLOCK_SIZE;
-    std::vector<uint8_t> result(edid_size, 0x0);
+    const size_t ext_blocks = edid.extension_blocks.has_value() ? edid.extension_blocks->size() : 0;
+    std::vector<uint8_t> result((ext_blocks + 1) * EDID_BLOCK_SIZE);
+    generate_edid_binary(edid, result.data(), result.size());
+    return result;
+  }
 
-    auto base_block = generate_base_block(edid.base_block, ext_blocks);
-    std::move(base_block.begin(), base_block.end(), result.begin());
+  size_t generate_edid_binary(const EdidData& edid, uint8_t* out, size_t size) {
+    const size_t ext_blocks = edid.extension_blocks.has_value() ? edid.extension_blocks->size() : 0;
+    const size_t edid_size = (ext_blocks + 1) * EDID_BLOCK_SIZE;
+    if (edid_size > size)
+      throw EdidException(__FUNCTION__, "EDID of " + std::to_string(edid_size) +
+        " bytes doesn't fit into " + std::to_string(size) + " bytes");
 
-    for (int i = 0; i < ext_blocks; ++i) {
-      auto cta861_block = generate_cta861_block(edid.extension_blocks->at(i));
-      std::move(cta861_block.begin(), cta861_block.end(), result.begin() + (i + 1) * EDID_BLOCK_SIZE);
-    }
+    write_base_block(edid.base_block, ext_blocks, out);
+    for (size_t i = 0; i < ext_blocks; ++i)
+      write_cta861_block((*edid.extension_blocks)[i], out + (i + 1) * EDID_BLOCK_SIZE);
 
-    return result;
+    return edid_size;
   }
 
   EdidData parse_edid_binary(const std::vector<uint8_t>& edid) {
-    if (edid.size() == 0 || edid.size() % EDID_BLOCK_SIZE != 0)
-      throw EdidException(__FUNCTION__, "EDID size " + std::to_string(edid.size()) +
+    return parse_edid_binary(edid.data(), edid.size());
+  }
+
+  EdidData parse_edid_binary(const uint8_t* edid, size_t size, std::pmr::memory_resource* resource) {
+    if (size == 0 || size % EDID_BLOCK_SIZE != 0)
+      throw EdidException(__FUNCTION__, "EDID size " + std::to_string(size) +
         " is not a factor of " +
         std::to_string(EDID_BLOCK_SIZE)
       );
 
     EdidData result;
-    std::array<uint8_t, EDID_BLOCK_SIZE> base;
-    std::move(edid.begin(), edid.begin() + EDID_BLOCK_SIZE, base.begin());
-    auto [base_edid, extension_blocks] = parse_base_block(base);
+    auto [base_edid, extension_blocks] = parse_base_block(edid);
+
+    if ((size_t{extension_blocks} + 1) * EDID_BLOCK_SIZE > size)
+      throw EdidException(__FUNCTION__, "EDID Base Block announces " +
+        std::to_string(extension_blocks) + " extension blocks but EDID size is " +
+        std::to_string(size)
+      );
 
     result.base_block = base_edid;
-    if (extension_blocks != 0)
+    if (extension_blocks != 0) {
       result.extension_blocks = std::vector<Cta861Block>();
-    for (int i = 0; i < extension_blocks; ++i) {
-      std::array<uint8_t, EDID_BLOCK_SIZE> extension_block;
-      std::move(
-        edid.begin() + (i + 1) * EDID_BLOCK_SIZE,
-        edid.begin() + (i + 2) * EDID_BLOCK_SIZE,
-        extension_block.begin()
-      );
-      result.extension_blocks->push_back(parse_cta861_block(extension_block));
+      result.extension_blocks->reserve(extension_blocks);
+    }
+    for (size_t i = 0; i < extension_blocks; ++i) {
+      result.extension_blocks->push_back(parse_cta861_block(edid + (i + 1) * EDID_BLOCK_SIZE, resource));
+    }
+
+    return result;
+  }
+
+  ParseResult<EdidData> try_parse_edid_binary(const std::vector<uint8_t>& edid) {
+    return try_parse_edid_binary(edid.data(), edid.size());
+  }
+
+  std::optional<ParseError> check_edid_binary(const uint8_t* edid, size_t size) {
+    if (size == 0 || size % EDID_BLOCK_SIZE != 0)
+      return ParseError{PE_INVALID_SIZE, 0, 0, static_cast<uint32_t>(size)};
+
+    if (auto error = check_base_block(edid))
+      return error;
+
+    const uint8_t extension_blocks = edid[EDID_BLOCK_SIZE - 2];
+    if ((size_t{extension_blocks} + 1) * EDID_BLOCK_SIZE > size)
+      return ParseError{PE_TRUNCATED, 0, EDID_BLOCK_SIZE - 2, extension_blocks};
+
+    for (unsigned i = 1; i <= extension_blocks; ++i) {
+      if (auto error = check_cta861_block(edid + i * EDID_BLOCK_SIZE)) {
+        error->block_index = i;
+        error->byte_offset += i * EDID_BLOCK_SIZE;
+        return error;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  ParseResult<EdidData> try_parse_edid_binary(const uint8_t* edid, size_t size, std::pmr::memory_resource* resource) {
+    if (auto error = check_edid_binary(edid, size))
+      return *error;
+
+    // The checks above cover what the parser validates, anything it still rejects
+    // is reported as malformed at the start of the offending block
+    EdidData result;
+    try {
+      result.base_block = parse_base_block(edid).first;
+    }
+    catch (const std::bad_alloc&) {
+      throw;
+    }
+    catch (const std::exception&) {
+      return ParseError{PE_MALFORMED, 0, 0};
+    }
+
+    const uint8_t extension_blocks = edid[EDID_BLOCK_SIZE - 2];
+    if (extension_blocks != 0) {
+      result.extension_blocks = std::vector<Cta861Block>();
+      result.extension_blocks->reserve(extension_blocks);
+    }
+    for (unsigned i = 1; i <= extension_blocks; ++i) {
+      try {
+        result.extension_blocks->push_back(parse_cta861_block(edid + i * EDID_BLOCK_SIZE, resource));
+      }
+      catch (const std::bad_alloc&) {
+        throw;
+      }
+      catch (const std::exception&) {
+        return ParseError{PE_MALFORMED, static_cast<uint8_t>(i), i * EDID_BLOCK_SIZE};
+      }
+    }
+
+    return result;
+  }
+
+  std::vector<ParseResult<EdidData>> parse_edid_batch(const std::vector<std::vector<uint8_t>>& edids, unsigned threads) {
+    std::vector<EdidBinaryRef> refs;
+    refs.reserve(edids.size());
+    for (const auto& edid : edids)
+      refs.push_back({edid.data(), edid.size()});
+    return parse_edid_batch(refs.data(), refs.size(), threads);
+  }
+
+  std::vector<ParseResult<EdidData>> parse_edid_batch(const EdidBinaryRef* edids, size_t count, unsigned threads) {
+    std::vector<ParseResult<EdidData>> result(count, ParseError{PE_MALFORMED});
+    const size_t chunks = (count + EDID_BATCH_CHUNK_SIZE - 1) / EDID_BATCH_CHUNK_SIZE;
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(chunks, 1));
+
+    // Threads claim chunks of the batch until none are left, so that slow EDIDs
+    // don't keep the other threads idle
+    // A failure of one item, even std::bad_alloc, is reported in its result and doesn't stop the batch
+    std::atomic<size_t> next_chunk{0};
+    auto worker = [&]() {
+      for (size_t chunk; (chunk = next_chunk++) < chunks;) {
+        const size_t end = std::min(count, (chunk + 1) * EDID_BATCH_CHUNK_SIZE);
+        for (size_t i = chunk * EDID_BATCH_CHUNK_SIZE; i < end; ++i) {
+          try {
+            result[i] = try_parse_edid_binary(edids[i].data, edids[i].size);
+          }
+          catch (...) {
+            result[i] = ParseError{PE_MALFORMED};
+          }
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    try {
+      for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    }
+    catch (const std::system_error&) {
+      // Out of threads, the ones already started and the calling thread share the remaining chunks
     }
+    worker();
+    for (auto& thread : workers)
+      thread.join();
+
+    return result;
+  }
+
+  EdidView::EdidView(const uint8_t* edid, size_t size)
+    : edid_(edid)
+    , size_(size)
+  {
+    if (size == 0 || size % EDID_BLOCK_SIZE != 0)
+      throw EdidException(__FUNCTION__, "EDID size " + std::to_string(size) +
+        " is not a factor of " +
+        std::to_string(EDID_BLOCK_SIZE)
+      );
+
+    if (!std::equal(base_block_header.begin(), base_block_header.end(), edid))
+      throw EdidException(__FUNCTION__, "EDID base block header is invalid.");
+  }
+
+  uint8_t EdidView::extension_blocks() const {
+    return std::min<size_t>(edid_[EDID_BLOCK_SIZE - 2], size_ / EDID_BLOCK_SIZE - 1);
+  }
+
+  const uint8_t* EdidView::block(uint8_t i) const {
+    if (i > extension_blocks())
+      return nullptr;
+    return edid_ + i * EDID_BLOCK_SIZE;
+  }
+
+  std::array<char, 3> EdidView::manufacturer_id() const {
+    return {
+      static_cast<char>((edid_[8] >> 2 & BITMASK_TRUE(5)) + 64),
+      static_cast<char>((((edid_[8] & BITMASK_TRUE(2)) << 3) | (edid_[9] >> 5 & BITMASK_TRUE(3))) + 64),
+      static_cast<char>((edid_[9] & BITMASK_TRUE(5)) + 64)
+    };
+  }
+
+  uint16_t EdidView::product_code() const {
+    return edid_[10] | edid_[11] << 8;
+  }
+
+  uint32_t EdidView::serial_number() const {
+    return edid_[12] | edid_[13] << 8 | edid_[14] << 16 | static_cast<uint32_t>(edid_[15]) << 24;
+  }
+
+  std::optional<DetailedTimingDescriptor> EdidView::preferred_dtd() const {
+    const uint8_t* descriptor = edid_ + 54;
+    if (descriptor[0] == 0x0 && descriptor[1] == 0x0)
+      return std::nullopt;
+    return DetailedTimingDescriptor::parse_byte_block(descriptor);
+  }
+
+  std::vector<uint8_t> EdidView::vics() const {
+    std::vector<uint8_t> result;
+    for_each_vic([&result](uint8_t vic) {
+      result.push_back(vic);
+    });
+    return result;
+  }
 
+  std::optional<uint16_t> EdidView::hdmi_max_tmds_clock_mhz() const {
+    std::optional<uint16_t> result;
+    for_each_data_block([&result](const uint8_t* data_block) {
+      if ((*data_block >> 5 & BITMASK_TRUE(3)) != CTA861_VENDOR_DATA_BLOCK_TAG)
+        return false;
+      const uint8_t length = *data_block & BITMASK_TRUE(5);
+      if (length < 3 || !std::equal(hdmi_oui_little_endian.begin(), hdmi_oui_little_endian.end(), data_block + 1))
+        return false;
+      if (length >= 7)
+        result = data_block[7] * 5;
+      return true;
+    });
     return result;
   }
 }  // namespace Edid
@@ -0,0 +1,176 @@
+// Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "edid/edid_cache.hh"
+
+#ifdef ENABLE_JSON
+#include "edid/bcp00501.hh"
+#endif
+
+namespace Edid {
+  // Finalizer of MurmurHash3
+  static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    x ^= x >> 33;
+    return x;
+  }
+
+  uint64_t hash_edid_binary(const uint8_t* data, size_t size) {
+    uint64_t hash = size * 0x9e3779b97f4a7c15;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, data + i, sizeof(word));
+      hash = (hash ^ mix(word)) * 0x9e3779b97f4a7c15;
+    }
+    uint64_t tail = 0;
+    // memcpy() requires a valid pointer even for zero bytes, and data may be nullptr for an empty binary
+    if (size != i)
+      std::memcpy(&tail, data + i, size - i);
+    return mix(hash ^ tail);
+  }
+
+  struct EdidCache::Entry {
+    Entry(uint64_t hash, const uint8_t* data, size_t size)
+      : hash(hash)
+      , binary(data, data + size)
+      , edid(parse_edid_binary(data, size))
+    {}
+
+    bool matches(const uint8_t* data, size_t size) const {
+      return binary.size() == size && std::equal(binary.begin(), binary.end(), data);
+    }
+
+    size_t cost() const { return binary.size() + EDID_CACHE_ENTRY_OVERHEAD; }
+
+    const uint64_t hash;
+    const std::vector<uint8_t> binary;
+    const EdidData edid;
+
+    // Derived data is computed at first request
+    std::once_flag modes_flag;
+    ModeSet modes;
+#ifdef ENABLE_JSON
+    std::once_flag constraint_sets_flag;
+    nlohmann::json constraint_sets;
+#endif
+  };
+
+  EdidCache::EdidCache(size_t memory_budget)
+    : memory_budget_(memory_budget)
+  {}
+
+  EdidCache::~EdidCache() = default;
+
+  std::shared_ptr<const EdidData> EdidCache::edid(const uint8_t* data, size_t size) {
+    std::shared_ptr<Entry> entry = find_or_parse(data, size);
+    return std::shared_ptr<const EdidData>(entry, &entry->edid);
+  }
+
+  std::shared_ptr<const EdidData> EdidCache::edid(const std::vector<uint8_t>& binary) {
+    return edid(binary.data(), binary.size());
+  }
+
+  std::shared_ptr<const ModeSet> EdidCache::modes(const uint8_t* data, size_t size) {
+    std::shared_ptr<Entry> entry = find_or_parse(data, size);
+    std::call_once(entry->modes_flag, [&entry] {
+      entry->modes = ModeSet(entry->edid);
+    });
+    return std::shared_ptr<const ModeSet>(entry, &entry->modes);
+  }
+
+  std::shared_ptr<const ModeSet> EdidCache::modes(const std::vector<uint8_t>& binary) {
+    return modes(binary.data(), binary.size());
+  }
+
+#ifdef ENABLE_JSON
+  std::shared_ptr<const nlohmann::json> EdidCache::constraint_sets(const uint8_t* data, size_t size) {
+    std::shared_ptr<Entry> entry = find_or_parse(data, size);
+    std::call_once(entry->constraint_sets_flag, [&entry] {
+      entry->constraint_sets = generate_constraint_sets(entry->edid);
+    });
+    return std::shared_ptr<const nlohmann::json>(entry, &entry->constraint_sets);
+  }
+
+  std::shared_ptr<const nlohmann::json> EdidCache::constraint_sets(const std::vector<uint8_t>& binary) {
+    return constraint_sets(binary.data(), binary.size());
+  }
+#endif
+
+  size_t EdidCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+  }
+
+  size_t EdidCache::memory_usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_usage_;
+  }
+
+  size_t EdidCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  size_t EdidCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  void EdidCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    memory_usage_ = 0;
+  }
+
+  std::shared_ptr<EdidCache::Entry> EdidCache::find_or_parse(const uint8_t* data, size_t size) {
+    const uint64_t hash = hash_edid_binary(data, size);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(hash);
+      if (it != index_.end() && (*it->second)->matches(data, size)) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++hits_;
+        return lru_.front();
+      }
+      ++misses_;
+    }
+
+    // Parse without holding the lock, so concurrent misses of one EDID may parse it more than once
+    auto entry = std::make_shared<Entry>(hash, data, size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+      if ((*it->second)->matches(data, size)) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return lru_.front();
+      }
+      // Hash collision, the latest EDID takes the slot
+      memory_usage_ -= (*it->second)->cost();
+      lru_.erase(it->second);
+      index_.erase(it);
+    }
+
+    lru_.push_front(entry);
+    index_.emplace(hash, lru_.begin());
+    memory_usage_ += entry->cost();
+    evict();
+    return entry;
+  }
+
+  void EdidCache::evict() {
+    while (memory_usage_ > memory_budget_ && !lru_.empty()) {
+      const std::shared_ptr<Entry>& entry = lru_.back();
+      memory_usage_ -= entry->cost();
+      index_.erase(entry->hash);
+      lru_.pop_back();
+    }
+  }
+}  // namespace Edid
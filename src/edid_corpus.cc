@@ -0,0 +1,208 @@
+// Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <cstring>
+
+#include "edid/edid_cache.hh"
+#include "edid/edid_corpus.hh"
+
+namespace Edid {
+  static void put_le(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i)
+      out[i] = (value >> (8 * i)) & BITMASK_TRUE(8);
+  }
+
+  static uint64_t get_le(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i)
+      value |= uint64_t{in[i]} << (8 * i);
+    return value;
+  }
+
+  EdidCorpusWriter::EdidCorpusWriter(const std::string& file_path)
+    : file_(file_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc)
+  {
+    if (!file_)
+      throw EdidException(__FUNCTION__, "Can't open " + file_path);
+    file_.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+
+    // The header is written by close() when the index offset is known
+    const char header[EDID_CORPUS_HEADER_SIZE] = {};
+    file_.write(header, sizeof(header));
+  }
+
+  EdidCorpusWriter::~EdidCorpusWriter() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  void EdidCorpusWriter::add(const uint8_t* edid, size_t size) {
+    if (closed_)
+      throw EdidException(__FUNCTION__, "Corpus is closed");
+    if (index_.size() == UINT32_MAX)
+      throw EdidException(__FUNCTION__, "Corpus is full");
+    if (auto error = check_edid_binary(edid, size))
+      throw EdidException(__FUNCTION__, "Invalid EDID binary: " + error->message());
+
+    const EdidView view(edid, size);
+    index_.push_back(EdidCorpusEntry{
+      offset_,
+      hash_edid_binary(edid, size),
+      static_cast<uint16_t>(size),
+      view.product_code(),
+      view.manufacturer_id()
+    });
+    file_.write(reinterpret_cast<const char*>(edid), size);
+    offset_ += size;
+  }
+
+  void EdidCorpusWriter::add(const std::vector<uint8_t>& edid) {
+    add(edid.data(), edid.size());
+  }
+
+  void EdidCorpusWriter::close() {
+    if (closed_)
+      return;
+    closed_ = true;
+
+    std::vector<uint8_t> index(index_.size() * EDID_CORPUS_ENTRY_SIZE);
+    for (size_t i = 0; i < index_.size(); ++i) {
+      const EdidCorpusEntry& entry = index_[i];
+      uint8_t* out = index.data() + i * EDID_CORPUS_ENTRY_SIZE;
+      put_le(out, entry.offset, 8);
+      put_le(out + 8, entry.hash, 8);
+      put_le(out + 16, entry.size, 2);
+      put_le(out + 18, entry.product_code, 2);
+      std::copy(entry.manufacturer_id.begin(), entry.manufacturer_id.end(), out + 20);
+    }
+    file_.write(reinterpret_cast<const char*>(index.data()), index.size());
+
+    // Stable sort keeps equal hashes in record order, so find() returns the first record
+    std::vector<uint32_t> order(index_.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+      return index_[lhs].hash < index_[rhs].hash;
+    });
+    std::vector<uint8_t> lookup(order.size() * EDID_CORPUS_LOOKUP_ENTRY_SIZE);
+    for (size_t i = 0; i < order.size(); ++i)
+      put_le(lookup.data() + i * EDID_CORPUS_LOOKUP_ENTRY_SIZE, order[i], EDID_CORPUS_LOOKUP_ENTRY_SIZE);
+    file_.write(reinterpret_cast<const char*>(lookup.data()), lookup.size());
+
+    uint8_t header[EDID_CORPUS_HEADER_SIZE] = {};
+    std::memcpy(header, EDID_CORPUS_MAGIC, EDID_CORPUS_MAGIC_SIZE);
+    put_le(header + 8, EDID_CORPUS_VERSION, 4);
+    put_le(header + 12, EDID_CORPUS_ENTRY_SIZE, 4);
+    put_le(header + 16, index_.size(), 8);
+    put_le(header + 24, offset_, 8);
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file_.close();
+  }
+
+  static MappedFile map_corpus(const std::string& file_path) {
+    try {
+      return MappedFile(file_path);
+    } catch (const std::exception& e) {
+      throw EdidException("EdidCorpus", e.what());
+    }
+  }
+
+  EdidCorpus::EdidCorpus(const std::string& file_path)
+    : file_(map_corpus(file_path))
+    , data_(file_.data())
+  {
+    const size_t file_size = file_.size();
+    if (file_size < EDID_CORPUS_HEADER_SIZE || std::memcmp(data_, EDID_CORPUS_MAGIC, EDID_CORPUS_MAGIC_SIZE) != 0)
+      throw EdidException(__FUNCTION__, file_path + " is not an EDID corpus");
+    if (get_le(data_ + 8, 4) != EDID_CORPUS_VERSION || get_le(data_ + 12, 4) != EDID_CORPUS_ENTRY_SIZE)
+      throw EdidException(__FUNCTION__, file_path + " has unsupported version of EDID corpus");
+
+    const uint64_t count = get_le(data_ + 16, 8);
+    const uint64_t index_offset = get_le(data_ + 24, 8);
+    const size_t record_size = EDID_CORPUS_ENTRY_SIZE + EDID_CORPUS_LOOKUP_ENTRY_SIZE;
+    if (index_offset < EDID_CORPUS_HEADER_SIZE || index_offset > file_size ||
+        count != (file_size - index_offset) / record_size ||
+        (file_size - index_offset) % record_size != 0)
+      throw EdidException(__FUNCTION__, file_path + " has truncated index");
+    size_ = count;
+    index_ = data_ + index_offset;
+    lookup_ = index_ + size_ * EDID_CORPUS_ENTRY_SIZE;
+
+    // Records can be accessed without bounds checks from now on
+    for (size_t i = 0; i < size_; ++i) {
+      const uint8_t* entry = entry_data(i);
+      const uint64_t offset = get_le(entry, 8);
+      const uint64_t size = get_le(entry + 16, 2);
+      if (offset < EDID_CORPUS_HEADER_SIZE || offset > index_offset || size > index_offset - offset ||
+          size == 0 || size % EDID_BLOCK_SIZE != 0)
+        throw EdidException(__FUNCTION__, file_path + " has record " + std::to_string(i) + " out of bounds");
+    }
+
+    // find() relies on the lookup table being ordered by hash
+    for (size_t i = 0; i < size_; ++i) {
+      if (lookup_record(i) >= size_ ||
+          (i > 0 && get_le(entry_data(lookup_record(i - 1)) + 8, 8) > get_le(entry_data(lookup_record(i)) + 8, 8)))
+        throw EdidException(__FUNCTION__, file_path + " has unordered lookup table");
+    }
+  }
+
+  const uint8_t* EdidCorpus::entry_data(size_t i) const {
+    return index_ + i * EDID_CORPUS_ENTRY_SIZE;
+  }
+
+  size_t EdidCorpus::lookup_record(size_t i) const {
+    return get_le(lookup_ + i * EDID_CORPUS_LOOKUP_ENTRY_SIZE, EDID_CORPUS_LOOKUP_ENTRY_SIZE);
+  }
+
+  EdidCorpusEntry EdidCorpus::entry(size_t i) const {
+    if (i >= size_)
+      throw EdidException(__FUNCTION__, "EDID corpus has no record " + std::to_string(i));
+    const uint8_t* entry = entry_data(i);
+    EdidCorpusEntry result;
+    result.offset = get_le(entry, 8);
+    result.hash = get_le(entry + 8, 8);
+    result.size = get_le(entry + 16, 2);
+    result.product_code = get_le(entry + 18, 2);
+    std::copy(entry + 20, entry + 23, result.manufacturer_id.begin());
+    return result;
+  }
+
+  EdidView EdidCorpus::view(size_t i) const {
+    const EdidCorpusEntry record = entry(i);
+    return EdidView(data_ + record.offset, record.size);
+  }
+
+  std::optional<size_t> EdidCorpus::find(const uint8_t* edid, size_t size) const {
+    const uint64_t hash = hash_edid_binary(edid, size);
+    const auto record_hash = [this](size_t i) {
+      return get_le(entry_data(lookup_record(i)) + 8, 8);
+    };
+
+    // Lower bound of the hash in the lookup table
+    size_t first = 0;
+    for (size_t count = size_; count > 0;) {
+      const size_t step = count / 2;
+      if (record_hash(first + step) < hash) {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else {
+        count = step;
+      }
+    }
+
+    for (size_t i = first; i < size_ && record_hash(i) == hash; ++i) {
+      const size_t record = lookup_record(i);
+      const uint8_t* entry = entry_data(record);
+      if (get_le(entry + 16, 2) == size && std::equal(edid, edid + size, data_ + get_le(entry, 8)))
+        return record;
+    }
+    return std::nullopt;
+  }
+
+  std::optional<size_t> EdidCorpus::find(const std::vector<uint8_t>& edid) const {
+    return find(edid.data(), edid.size());
+  }
+}  // namespace Edid
@@ -0,0 +1,62 @@
+// Copyright 2023 N-Nagorny
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "edid/edid_encoder.hh"
+
+namespace Edid {
+  EdidEncoder::EdidEncoder(EdidData edid)
+    : edid_(std::move(edid))
+  {
+    binary_ = generate_edid_binary(edid_);
+    dirty_.assign(extension_blocks_count() + 1, false);
+  }
+
+  void EdidEncoder::set_extension_blocks(std::optional<std::vector<Cta861Block>> extension_blocks) {
+    edid_.extension_blocks = std::move(extension_blocks);
+    const size_t blocks = extension_blocks_count() + 1;
+    binary_.resize(blocks * EDID_BLOCK_SIZE);
+    // The Base Block carries the number of extension blocks
+    dirty_.assign(blocks, true);
+  }
+
+  void EdidEncoder::set_serial_number(uint32_t serial_number) {
+    edid_.base_block.serial_number = serial_number;
+    for (int i = 0; i < 4; ++i)
+      binary_[12 + i] = (serial_number >> (8 * i)) & BITMASK_TRUE(8);
+    binary_[EDID_BLOCK_SIZE - 1] = calculate_block_checksum(binary_.data());
+  }
+
+  void EdidEncoder::set_product_code(uint16_t product_code) {
+    edid_.base_block.product_code = product_code;
+    binary_[10] = product_code & BITMASK_TRUE(8);
+    binary_[11] = (product_code >> 8) & BITMASK_TRUE(8);
+    binary_[EDID_BLOCK_SIZE - 1] = calculate_block_checksum(binary_.data());
+  }
+
+  const std::vector<uint8_t>& EdidEncoder::binary() {
+    if (dirty_[0]) {
+      write_base_block(edid_.base_block, extension_blocks_count(), binary_.data());
+      dirty_[0] = false;
+    }
+    for (size_t i = 1; i < dirty_.size(); ++i) {
+      if (dirty_[i]) {
+        write_cta861_block((*edid_.extension_blocks)[i - 1], binary_.data() + i * EDID_BLOCK_SIZE);
+        dirty_[i] = false;
+      }
+    }
+    return binary_;
+  }
+
+  size_t EdidEncoder::extension_blocks_count() const {
+    return edid_.extension_blocks.has_value() ? edid_.extension_blocks->size() : 0;
+  }
+
+  Cta861Block& EdidEncoder::mark_extension_block(size_t i) {
+    if (i >= extension_blocks_count())
+      throw EdidException(__FUNCTION__, "EDID has no extension block " + std::to_string(i));
+    dirty_[i + 1] = true;
+    return (*edid_.extension_blocks)[i];
+  }
+}  // namespace Edid
@@ -0,0 +1,87 @@
+// Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "edid/edid_stream.hh"
+
+namespace Edid {
+  EdidStreamReader::EdidStreamReader(std::istream& is, std::pmr::memory_resource* resource)
+    : is_(is)
+    , resource_(resource)
+  {}
+
+  std::optional<EdidData> EdidStreamReader::next() {
+    while (size_t size = find_edid()) {
+      auto result = try_parse_edid_binary(buffer_.data() + begin_, size, resource_);
+      if (result) {
+        consume(size);
+        return std::move(*result);
+      }
+      skip(1);
+    }
+    return std::nullopt;
+  }
+
+  std::optional<EdidView> EdidStreamReader::next_view() {
+    const size_t size = find_edid();
+    if (size == 0)
+      return std::nullopt;
+
+    EdidView view(buffer_.data() + begin_, size);
+    consume(size);
+    return view;
+  }
+
+  size_t EdidStreamReader::find_edid() {
+    while (fill(EDID_BLOCK_SIZE)) {
+      const auto window = buffer_.begin() + begin_;
+      if (!std::equal(base_block_header.begin(), base_block_header.end(), window)) {
+        // Resynchronise on the next header, keeping a tail which may be its beginning
+        auto header = std::search(window + 1, buffer_.end(), base_block_header.begin(), base_block_header.end());
+        if (header == buffer_.end())
+          header -= base_block_header.size() - 1;
+        skip(header - window);
+        continue;
+      }
+
+      const size_t size = (window[EDID_BLOCK_SIZE - 2] + 1) * EDID_BLOCK_SIZE;
+      if (fill(size) && !check_edid_binary(buffer_.data() + begin_, size))
+        return size;
+      skip(1);
+    }
+
+    skip(buffer_.size() - begin_);
+    return 0;
+  }
+
+  bool EdidStreamReader::fill(size_t size) {
+    if (buffer_.size() - begin_ >= size)
+      return true;
+
+    // Drop the bytes before the window so that the buffer never outgrows the largest EDID
+    buffer_.erase(buffer_.begin(), buffer_.begin() + begin_);
+    begin_ = 0;
+
+    while (buffer_.size() < size && is_) {
+      const size_t available = buffer_.size();
+      buffer_.resize(available + std::max<size_t>(size - available, EDID_STREAM_READ_SIZE));
+      is_.read(reinterpret_cast<char*>(buffer_.data() + available), buffer_.size() - available);
+      buffer_.resize(available + is_.gcount());
+    }
+
+    return buffer_.size() >= size;
+  }
+
+  void EdidStreamReader::consume(size_t size) {
+    offset_ = position_;
+    begin_ += size;
+    position_ += size;
+  }
+
+  void EdidStreamReader::skip(size_t size) {
+    begin_ += size;
+    position_ += size;
+    skipped_bytes_ += size;
+  }
+}  // namespace Edid
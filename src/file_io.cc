@@ -0,0 +1,198 @@
+// Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "edid/file_io.hh"
+#include "edid/filesystem.hh"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define EDID_POSIX_FILE_IO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Edid {
+#ifdef EDID_POSIX_FILE_IO
+  namespace {
+    class FileDescriptor {
+     public:
+      // O_NONBLOCK keeps FIFOs from blocking open(), fstat() rejects them afterwards
+      explicit FileDescriptor(const std::string& file_path)
+        : fd_(::open(file_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC))
+      {
+        if (fd_ < 0)
+          throw std::runtime_error("Can't open " + file_path + ": " + std::strerror(errno));
+      }
+
+      ~FileDescriptor() {
+        if (fd_ >= 0)
+          ::close(fd_);
+      }
+
+      FileDescriptor(FileDescriptor&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+      {}
+      FileDescriptor(const FileDescriptor&) = delete;
+      FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+      int get() const { return fd_; }
+
+     private:
+      int fd_;
+    };
+
+    size_t regular_file_size(const FileDescriptor& fd, const std::string& file_path) {
+      struct stat st;
+      if (::fstat(fd.get(), &st) != 0 || !S_ISREG(st.st_mode))
+        throw std::runtime_error(file_path + " is not a regular file");
+      return st.st_size;
+    }
+
+    // Takes a single read() unless the file is read concurrently with its modification
+    std::vector<uint8_t> read_all(const FileDescriptor& fd, const std::string& file_path) {
+      std::vector<uint8_t> contents(regular_file_size(fd, file_path));
+      size_t size = 0;
+      while (size < contents.size()) {
+        const ssize_t n = ::read(fd.get(), contents.data() + size, contents.size() - size);
+        if (n < 0 && errno == EINTR)
+          continue;
+        if (n < 0)
+          throw std::runtime_error("Can't read " + file_path + ": " + std::strerror(errno));
+        if (n == 0)
+          break;
+        size += n;
+      }
+      contents.resize(size);
+      return contents;
+    }
+  }  // namespace
+
+  std::vector<uint8_t> read_file(const std::string& file_path) {
+    return read_all(FileDescriptor(file_path), file_path);
+  }
+
+  MappedFile::MappedFile(const std::string& file_path) {
+    const FileDescriptor fd(file_path);
+    const size_t size = regular_file_size(fd, file_path);
+    // mmap() refuses empty mappings
+    if (size == 0)
+      return;
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (mapping == MAP_FAILED)
+      throw std::runtime_error("Can't map " + file_path + ": " + std::strerror(errno));
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = size;
+    mapped_ = true;
+  }
+
+  void MappedFile::unmap() {
+    if (mapped_)
+      ::munmap(const_cast<uint8_t*>(data_), size_);
+    mapped_ = false;
+  }
+#else
+  std::vector<uint8_t> read_file(const std::string& file_path) {
+    using namespace std;
+
+    if (!filesystem::is_regular_file(file_path))
+      throw runtime_error(file_path + " is not a regular file");
+
+    ifstream file(file_path,
+      ios_base::in | ios_base::binary
+    );
+    file.exceptions(ifstream::eofbit | ifstream::failbit | ifstream::badbit);
+
+    // Stop eating new lines in binary mode!!!
+    file.unsetf(ios::skipws);
+
+    // get its size
+    streampos file_size;
+
+    file.seekg(0, ios::end);
+    file_size = file.tellg();
+    file.seekg(0, ios::beg);
+
+    // reserve capacity
+    vector<uint8_t> vec(file_size);
+
+    // read the data
+    file.read(reinterpret_cast<char*>(vec.data()), file_size);
+
+    return vec;
+  }
+
+  MappedFile::MappedFile(const std::string& file_path)
+    : contents_(read_file(file_path))
+  {
+    data_ = contents_.empty() ? nullptr : contents_.data();
+    size_ = contents_.size();
+  }
+
+  void MappedFile::unmap() {}
+#endif
+
+  MappedFile::~MappedFile() {
+    unmap();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, false))
+    , contents_(std::move(other.contents_))
+  {}
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      mapped_ = std::exchange(other.mapped_, false);
+      contents_ = std::move(other.contents_);
+    }
+    return *this;
+  }
+
+  std::vector<LoadedFile> load_directory(const std::string& directory_path, bool recursive) {
+    std::vector<std::string> paths;
+    const auto collect = [&paths](auto&& directory) {
+      for (const auto& entry : directory) {
+        if (std::filesystem::is_regular_file(entry.status()))
+          paths.push_back(entry.path().string());
+      }
+    };
+    if (recursive)
+      collect(std::filesystem::recursive_directory_iterator(directory_path));
+    else
+      collect(std::filesystem::directory_iterator(directory_path));
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<LoadedFile> result;
+    result.reserve(paths.size());
+    for (size_t begin = 0; begin < paths.size(); begin += EDID_LOAD_DIRECTORY_BATCH) {
+      const size_t end = std::min(paths.size(), begin + EDID_LOAD_DIRECTORY_BATCH);
+#ifdef EDID_POSIX_FILE_IO
+      std::vector<FileDescriptor> batch;
+      batch.reserve(end - begin);
+      for (size_t i = begin; i < end; ++i) {
+        batch.emplace_back(paths[i]);
+#ifdef POSIX_FADV_WILLNEED
+        ::posix_fadvise(batch.back().get(), 0, 0, POSIX_FADV_WILLNEED);
+#endif
+      }
+      for (size_t i = begin; i < end; ++i)
+        result.push_back(LoadedFile{paths[i], read_all(batch[i - begin], paths[i])});
+#else
+      for (size_t i = begin; i < end; ++i)
+        result.push_back(LoadedFile{paths[i], read_file(paths[i])});
+#endif
+    }
+    return result;
+  }
+}  // namespace Edid
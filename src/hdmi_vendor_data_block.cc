@@ -2,11 +2,11 @@
 #include "edid/hdmi_vendor_data_block.hh"
 
 namespace Edid {
-  std::vector<uint8_t> HdmiVendorDataBlock::generate_byte_block() const {
+  uint8_t* HdmiVendorDataBlock::write_byte_block(uint8_t* result) const {
     if (size() - CTA861_DATA_BLOCK_HEADER_SIZE > 31)
       throw EdidException("HDMI VDB is longer than 31 bytes.");
 
-    std::vector<uint8_t> result(size(), 0x0);
+    std::fill_n(result, size(), 0x00);
     int pos = 0;
 
     result[pos] = CTA861_VENDOR_DATA_BLOCK_TAG << 5;
@@ -102,7 +102,7 @@ namespace Edid {
       result[pos++] = caps;
     }
 
-    return result;
+    return result + size();
   }
 
   // TODO(N-Nagorny)
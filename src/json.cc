@@ -1,5 +1,9 @@
 // Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <exception>
+
 #include "edid/json.hh"
+#include "edid/json_schemas.hh"
 
 namespace Edid {
   void from_json(const nlohmann::json& j, std::variant<AnalogCompositeSync, DigitalCompositeSync, DigitalSeparateSync>& sync) {
@@ -297,11 +301,21 @@ namespace Edid {
     j = std::move(result);
   }
 
+  // JSON arrays which are std::array in EdidData may be shorter, the rest stays default
+  template <typename T, typename U, size_t N>
+  static void copy_to_fixed_array(const std::vector<T>& elements, std::array<U, N>& result, const char* name) {
+    if (elements.size() > N)
+      throw EdidException("from_json", std::string(name) + " has more than " + std::to_string(N) + " elements");
+    std::copy(elements.begin(), elements.end(), result.begin());
+  }
+
   void from_json(const nlohmann::json& j, BaseBlock& base_block) {
     BaseBlock result;
 
-    for (int i = 0; i < 3; ++i)
-      result.manufacturer_id[i] = j.at("manufacturer_id").get<std::string>().at(i);
+    const auto manufacturer_id = j.at("manufacturer_id").get<std::string>();
+    if (manufacturer_id.size() < result.manufacturer_id.size())
+      throw EdidException(__FUNCTION__, "manufacturer_id is too short");
+    std::copy_n(manufacturer_id.begin(), result.manufacturer_id.size(), result.manufacturer_id.begin());
     result.product_code = j.at("product_code");
     result.serial_number = j.at("serial_number");
     result.manufacture_date_or_model_year = j.at("manufacture_date_or_model_year");
@@ -319,10 +333,7 @@ namespace Edid {
     result.standard_srgb = j.at("srgb_is_primary");
     result.preferred_timing_mode = j.at("preferred_timing_mode");
     result.continuous_timings = j.at("continuous_timings");
-    auto chromaticity = j.at("chromaticity").get<std::vector<uint8_t>>();
-    for (int i = 0; i < chromaticity.size(); ++i) {
-      result.chromaticity[i] = chromaticity.at(i);
-    }
+    copy_to_fixed_array(j.at("chromaticity").get<std::vector<uint8_t>>(), result.chromaticity, "chromaticity");
     auto et_1 = j.at("established_timings_1").get<std::vector<EstablishedTiming1>>();
     for (auto et : et_1) {
       result.established_timings_1 |= et;
@@ -335,14 +346,8 @@ namespace Edid {
     for (auto et : et_3) {
       result.manufacturers_timings |= et;
     }
-    auto standard_timings = j.at("standard_timings").get<std::vector<StandardTiming>>();
-    for (int i = 0; i < standard_timings.size(); ++i) {
-      result.standard_timings[i] = standard_timings.at(i);
-    }
-    auto eighteen_byte_descriptors = j.at("eighteen_byte_descriptors").get<std::vector<EighteenByteDescriptor>>();
-    for (int i = 0; i < eighteen_byte_descriptors.size(); ++i) {
-      result.eighteen_byte_descriptors[i] = eighteen_byte_descriptors.at(i);
-    }
+    copy_to_fixed_array(j.at("standard_timings").get<std::vector<StandardTiming>>(), result.standard_timings, "standard_timings");
+    copy_to_fixed_array(j.at("eighteen_byte_descriptors").get<std::vector<EighteenByteDescriptor>>(), result.eighteen_byte_descriptors, "eighteen_byte_descriptors");
 
     base_block = std::move(result);
   }
@@ -663,4 +668,77 @@ namespace Edid {
 
     j_["hdmi_vsdb"] = j;
   }
+
+  static void validate_edid_json(const nlohmann::json& j) {
+    try {
+      json_schemas::get_validator("edid.json").validate(j);
+    } catch (const std::exception& e) {
+      throw EdidException(__FUNCTION__, e.what());
+    }
+  }
+
+  ValidatedEdidJson::ValidatedEdidJson(const EdidData& edid)
+    : json_(edid)
+  {}
+
+  ValidatedEdidJson ValidatedEdidJson::validate(nlohmann::json j) {
+    validate_edid_json(j);
+    return ValidatedEdidJson(std::move(j));
+  }
+
+  EdidData ValidatedEdidJson::edid() const {
+    return json_.get<EdidData>();
+  }
+
+  // Deserializing rejects documents which don't fit EdidData, nlohmann and std exceptions are wrapped
+  static EdidData edid_from_json(const nlohmann::json& j, const char* func_name) {
+    try {
+      return j.get<EdidData>();
+    } catch (const EdidException&) {
+      throw;
+    } catch (const std::exception& e) {
+      throw EdidException(func_name, e.what());
+    }
+  }
+
+  EdidData parse_edid_json(const nlohmann::json& j) {
+    validate_edid_json(j);
+    return edid_from_json(j, __FUNCTION__);
+  }
+
+  std::vector<uint8_t> generate_edid_cbor(const EdidData& edid) {
+    return nlohmann::json::to_cbor(nlohmann::json(edid));
+  }
+
+  std::vector<uint8_t> generate_edid_msgpack(const EdidData& edid) {
+    return nlohmann::json::to_msgpack(nlohmann::json(edid));
+  }
+
+  EdidData parse_edid_cbor(const uint8_t* data, size_t size) {
+    nlohmann::json j;
+    try {
+      j = nlohmann::json::from_cbor(data, data + size);
+    } catch (const nlohmann::json::exception& e) {
+      throw EdidException(__FUNCTION__, e.what());
+    }
+    return edid_from_json(j, __FUNCTION__);
+  }
+
+  EdidData parse_edid_cbor(const std::vector<uint8_t>& cbor) {
+    return parse_edid_cbor(cbor.data(), cbor.size());
+  }
+
+  EdidData parse_edid_msgpack(const uint8_t* data, size_t size) {
+    nlohmann::json j;
+    try {
+      j = nlohmann::json::from_msgpack(data, data + size);
+    } catch (const nlohmann::json::exception& e) {
+      throw EdidException(__FUNCTION__, e.what());
+    }
+    return edid_from_json(j, __FUNCTION__);
+  }
+
+  EdidData parse_edid_msgpack(const std::vector<uint8_t>& msgpack) {
+    return parse_edid_msgpack(msgpack.data(), msgpack.size());
+  }
 }  // namespace Edid
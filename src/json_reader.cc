@@ -0,0 +1,953 @@
+// Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "edid/json_reader.hh"
+
+// Members are dispatched by switch over FNV-1a hashes of their keys, the hashes of case labels
+// are computed at compile time. Two keys of one object with the same hash would be duplicate
+// case labels, so the hash is perfect on every key set which compiles.
+
+namespace Edid {
+  namespace {
+    constexpr uint64_t key_hash(std::string_view key) {
+      uint64_t hash = 0xcbf29ce484222325;
+      for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+      }
+      return hash;
+    }
+
+    class JsonReader {
+     public:
+      JsonReader(const char* data, size_t size)
+        : begin_(data)
+        , pos_(data)
+        , end_(data + size)
+      {}
+
+      // Consumes null if it's the next value
+      bool null() {
+        if (peek() != 'n')
+          return false;
+        literal("null");
+        return true;
+      }
+
+      bool boolean() {
+        switch (peek()) {
+          case 't':
+            literal("true");
+            return true;
+          case 'f':
+            literal("false");
+            return false;
+          default:
+            fail("expected a boolean");
+        }
+      }
+
+      uint64_t number() {
+        peek();
+        uint64_t value = 0;
+        const auto [ptr, ec] = std::from_chars(pos_, end_, value);
+        if (ec == std::errc::result_out_of_range)
+          fail("number is out of range");
+        if (ec != std::errc() || (ptr != end_ && (*ptr == '.' || *ptr == 'e' || *ptr == 'E')))
+          fail("expected a non-negative integer");
+        pos_ = ptr;
+        return value;
+      }
+
+      // The view is valid until the next string is read
+      std::string_view string() {
+        if (peek() != '"')
+          fail("expected a string");
+        const char* start = ++pos_;
+        // Strings without escapes, like all keys of EDID JSON, are viewed in place
+        while (pos_ != end_ && *pos_ != '"' && *pos_ != '\\' && static_cast<uint8_t>(*pos_) >= 0x20)
+          ++pos_;
+        if (pos_ != end_ && *pos_ == '"')
+          return std::string_view(start, pos_++ - start);
+
+        scratch_.assign(start, pos_);
+        while (true) {
+          if (pos_ == end_)
+            fail("unterminated string");
+          const char c = *pos_;
+          if (static_cast<uint8_t>(c) < 0x20)
+            fail("control character in string");
+          ++pos_;
+          if (c == '"')
+            return scratch_;
+          if (c != '\\') {
+            scratch_ += c;
+            continue;
+          }
+          if (pos_ == end_)
+            fail("unterminated string");
+          switch (*pos_++) {
+            case '"':  scratch_ += '"'; break;
+            case '\\': scratch_ += '\\'; break;
+            case '/':  scratch_ += '/'; break;
+            case 'b':  scratch_ += '\b'; break;
+            case 'f':  scratch_ += '\f'; break;
+            case 'n':  scratch_ += '\n'; break;
+            case 'r':  scratch_ += '\r'; break;
+            case 't':  scratch_ += '\t'; break;
+            case 'u':  unicode_escape(); break;
+            default:
+              --pos_;
+              fail("invalid escape");
+          }
+        }
+      }
+
+      // Calls member(key_hash(key)) for every member, which must read or skip its value
+      template <class F>
+      void object(F&& member) {
+        open('{');
+        if (close('}'))
+          return;
+        do {
+          const uint64_t key = key_hash(string());
+          expect(':');
+          member(key);
+        } while (next('}'));
+      }
+
+      // Calls element() for every element, which must read or skip it
+      template <class F>
+      void array(F&& element) {
+        open('[');
+        if (close(']'))
+          return;
+        do {
+          element();
+        } while (next(']'));
+      }
+
+      void skip() {
+        switch (peek()) {
+          case '{':
+            object([this](uint64_t) { skip(); });
+            break;
+          case '[':
+            array([this] { skip(); });
+            break;
+          case '"':
+            string();
+            break;
+          case 't':
+          case 'f':
+            boolean();
+            break;
+          case 'n':
+            literal("null");
+            break;
+          default: {
+            // Numbers of any form are skipped, they are read as integers only
+            const char* start = pos_;
+            while (pos_ != end_ && is_number_char(*pos_))
+              ++pos_;
+            if (pos_ == start)
+              fail("expected a value");
+          }
+        }
+      }
+
+      // Checks that nothing but whitespace follows the value
+      void end() {
+        skip_whitespace();
+        if (pos_ != end_)
+          fail("unexpected data after JSON");
+      }
+
+      [[noreturn]] void fail(const std::string& what) const {
+        throw EdidException("read_edid_json", what + " at offset " + std::to_string(pos_ - begin_));
+      }
+
+     private:
+      void skip_whitespace() {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t'))
+          ++pos_;
+      }
+
+      char peek() {
+        skip_whitespace();
+        if (pos_ == end_)
+          fail("unexpected end of JSON");
+        return *pos_;
+      }
+
+      void expect(char c) {
+        if (peek() != c)
+          fail(std::string("expected '") + c + "'");
+        ++pos_;
+      }
+
+      void literal(std::string_view word) {
+        if (std::string_view(pos_, std::min<size_t>(end_ - pos_, word.size())) != word)
+          fail("invalid literal");
+        pos_ += word.size();
+      }
+
+      void open(char bracket) {
+        expect(bracket);
+        if (++depth_ > EDID_JSON_READER_MAX_DEPTH)
+          fail("JSON is nested too deep");
+      }
+
+      // Consumes the closing bracket of the container if it's next
+      bool close(char bracket) {
+        if (peek() != bracket)
+          return false;
+        ++pos_;
+        --depth_;
+        return true;
+      }
+
+      // Consumes the comma before the next element, returns false at the end of the container
+      bool next(char bracket) {
+        if (close(bracket))
+          return false;
+        expect(',');
+        return true;
+      }
+
+      static bool is_number_char(char c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+      }
+
+      uint32_t hex_quad() {
+        uint32_t value = 0;
+        if (end_ - pos_ < 4 || std::from_chars(pos_, pos_ + 4, value, 16).ptr != pos_ + 4)
+          fail("invalid \\u escape");
+        pos_ += 4;
+        return value;
+      }
+
+      // Appends UTF-8 of the \u escape, pos_ is after 'u'
+      void unicode_escape() {
+        uint32_t code_point = hex_quad();
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u')
+            fail("unpaired surrogate");
+          pos_ += 2;
+          const uint32_t low = hex_quad();
+          if (low < 0xDC00 || low > 0xDFFF)
+            fail("unpaired surrogate");
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          fail("unpaired surrogate");
+        }
+
+        if (code_point < 0x80) {
+          scratch_ += static_cast<char>(code_point);
+        }
+        else if (code_point < 0x800) {
+          scratch_ += static_cast<char>(0xC0 | code_point >> 6);
+          scratch_ += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else if (code_point < 0x10000) {
+          scratch_ += static_cast<char>(0xE0 | code_point >> 12);
+          scratch_ += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+          scratch_ += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else {
+          scratch_ += static_cast<char>(0xF0 | code_point >> 18);
+          scratch_ += static_cast<char>(0x80 | (code_point >> 12 & 0x3F));
+          scratch_ += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+          scratch_ += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+      }
+
+      const char* const begin_;
+      const char* pos_;
+      const char* const end_;
+      int depth_ = 0;
+      std::string scratch_;  // Unescaped string
+    };
+
+    // Values
+
+    void read(JsonReader& r, bool& value) {
+      value = r.boolean();
+    }
+
+    template <class T>
+    std::enable_if_t<std::is_integral_v<T>> read(JsonReader& r, T& value) {
+      const uint64_t number = r.number();
+      if (number > std::numeric_limits<T>::max())
+        r.fail("number is out of range");
+      value = static_cast<T>(number);
+    }
+
+    template <class E>
+    std::enable_if_t<std::is_enum_v<E>> read(JsonReader& r, E& value) {
+      if (!from_string(r.string(), value))
+        r.fail("unknown enumerator");
+    }
+
+    template <class T>
+    void read(JsonReader& r, std::optional<T>& value) {
+      if (r.null())
+        value.reset();
+      else
+        read(r, value.emplace());
+    }
+
+    template <class E, class T>
+    void read_enum_array(JsonReader& r, T& bitfield) {
+      r.array([&r, &bitfield] {
+        E e;
+        read(r, e);
+        bitfield |= e;
+      });
+    }
+
+    // Sets the bit of the enumerator if it's named so, ENUM_NULL of split bitfields isn't a bit
+    template <class E, class T>
+    bool read_enum_bit(std::string_view name, T& bitfield) {
+      E e;
+      if (!from_string(name, e) || e == ENUM_NULL)
+        return false;
+      bitfield |= e;
+      return true;
+    }
+
+    // Appends the numbers to the container
+    template <class Container>
+    void read_number_array(JsonReader& r, Container& numbers) {
+      r.array([&r, &numbers] {
+        typename Container::value_type number;
+        read(r, number);
+        numbers.insert(numbers.end(), number);
+      });
+    }
+
+    // Fills the array from its beginning, the rest of elements keep their values
+    template <class T, size_t N, class F>
+    void read_fixed_array(JsonReader& r, std::array<T, N>& elements, F&& read_element) {
+      size_t i = 0;
+      r.array([&r, &elements, &read_element, &i] {
+        if (i == N)
+          r.fail("array has more than " + std::to_string(N) + " elements");
+        read_element(elements[i++]);
+      });
+    }
+
+    // Objects. read_member() reads the value of a known member and returns true,
+    // otherwise it returns false without reading anything
+
+    bool read_member(JsonReader& r, uint64_t key, ManufactureDate& date);
+    bool read_member(JsonReader& r, uint64_t key, ModelYear& year);
+    bool read_member(JsonReader& r, uint64_t key, StandardTiming& timing);
+    bool read_member(JsonReader& r, uint64_t key, DetailedTimingDescriptor& dtd);
+    bool read_member(JsonReader& r, uint64_t key, DummyDescriptor&);
+    bool read_member(JsonReader& r, uint64_t key, DisplayRangeLimits& limits);
+    bool read_member(JsonReader& r, uint64_t key, AsciiString& ascii_string);
+    bool read_member(JsonReader& r, uint64_t key, EstablishedTimings3& established_timings_3);
+    bool read_member(JsonReader& r, uint64_t key, BaseBlock& base_block);
+    bool read_member(JsonReader& r, uint64_t key, UnknownDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, VideoDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, ShortAudioDescriptor& sad);
+    bool read_member(JsonReader& r, uint64_t key, AudioDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, SpeakerAllocationDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, YCbCr420CapabilityMapDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, StereoVideoSupport& support);
+    bool read_member(JsonReader& r, uint64_t key, Vic3dSupport& support);
+    bool read_member(JsonReader& r, uint64_t key, HdmiVideoSubblock& block);
+    bool read_member(JsonReader& r, uint64_t key, HdmiVendorDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, HdrStaticMetadataDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, VideoCapabilityDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, ColorimetryDataBlock& block);
+    bool read_member(JsonReader& r, uint64_t key, Cta861Block& block);
+    bool read_member(JsonReader& r, uint64_t key, EdidData& edid);
+
+    template <class T>
+    void read_object(JsonReader& r, T& value) {
+      r.object([&r, &value](uint64_t key) {
+        if (!read_member(r, key, value))
+          r.skip();
+      });
+    }
+
+    // Emplaces the alternatives in turn until one of them has the member
+    template <class... Ts>
+    bool read_first_member(JsonReader& r, uint64_t key, std::variant<Ts...>& value) {
+      return ((value.template emplace<Ts>(), read_member(r, key, std::get<Ts>(value))) || ...);
+    }
+
+    // The first known member chooses the alternative, since members of the alternatives don't overlap.
+    // An object without known members is read as Empty.
+    template <class Empty, class Variant>
+    void read_variant(JsonReader& r, Variant& value) {
+      bool chosen = false;
+      r.object([&r, &value, &chosen](uint64_t key) {
+        bool known;
+        if (chosen)
+          known = std::visit([&r, key](auto& alternative) { return read_member(r, key, alternative); }, value);
+        else
+          known = chosen = read_first_member(r, key, value);
+        if (!known)
+          r.skip();
+      });
+      if (!chosen)
+        value = Empty{};
+    }
+
+    // Base Block
+
+    // Members of the sync alternatives overlap, so one is chosen like from_json() does after all are read
+    void read(JsonReader& r, std::variant<AnalogCompositeSync, DigitalCompositeSync, DigitalSeparateSync>& sync) {
+      AnalogCompositeSync analog;
+      DigitalCompositeSync composite;
+      DigitalSeparateSync separate;
+      bool has_bipolar = false;
+      bool has_v_sync_polarity = false;
+
+      r.object([&](uint64_t key) {
+        switch (key) {
+          case key_hash("bipolar"):
+            read(r, analog.bipolar);
+            has_bipolar = true;
+            break;
+          case key_hash("h_sync_polarity"):
+            read(r, separate.h_sync_polarity);
+            composite.h_sync_polarity = separate.h_sync_polarity;
+            break;
+          case key_hash("serrations"):
+            read(r, analog.serrations);
+            composite.serrations = analog.serrations;
+            break;
+          case key_hash("sync_on_rgb_signals"):
+            read(r, analog.sync_on_rgb_signals);
+            break;
+          case key_hash("v_sync_polarity"):
+            read(r, separate.v_sync_polarity);
+            has_v_sync_polarity = true;
+            break;
+          default:
+            r.skip();
+        }
+      });
+
+      if (has_bipolar)
+        sync = analog;
+      else if (has_v_sync_polarity)
+        sync = separate;
+      else
+        sync = composite;
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, DetailedTimingDescriptor& dtd) {
+      switch (key) {
+        case key_hash("h_blanking"):      read(r, dtd.h_blanking); return true;
+        case key_hash("h_border"):        read(r, dtd.h_border_pixels); return true;
+        case key_hash("h_front_porch"):   read(r, dtd.h_front_porch); return true;
+        case key_hash("h_image_size"):    read(r, dtd.h_image_size); return true;
+        case key_hash("h_res"):           read(r, dtd.h_res); return true;
+        case key_hash("h_sync_width"):    read(r, dtd.h_sync_width); return true;
+        case key_hash("interlaced"):      read(r, dtd.features_bitmap.interlaced); return true;
+        case key_hash("pixel_clock_khz"): dtd.pixel_clock_hz = r.number() * 1'000; return true;
+        case key_hash("stereo_mode"):     read(r, dtd.features_bitmap.stereo_mode); return true;
+        case key_hash("sync"):            read(r, dtd.features_bitmap.sync); return true;
+        case key_hash("v_blanking"):      read(r, dtd.v_blanking); return true;
+        case key_hash("v_border"):        read(r, dtd.v_border_lines); return true;
+        case key_hash("v_front_porch"):   read(r, dtd.v_front_porch); return true;
+        case key_hash("v_image_size"):    read(r, dtd.v_image_size); return true;
+        case key_hash("v_res"):           read(r, dtd.v_res); return true;
+        case key_hash("v_sync_width"):    read(r, dtd.v_sync_width); return true;
+        default:                          return false;
+      }
+    }
+
+    bool read_member(JsonReader&, uint64_t, DummyDescriptor&) {
+      return false;
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, DisplayRangeLimits& limits) {
+      switch (key) {
+        case key_hash("max_h_rate_khz"):           read(r, limits.max_h_rate_khz); return true;
+        case key_hash("max_pixel_clock_rate_mhz"): read(r, limits.max_pixel_clock_rate_mhz); return true;
+        case key_hash("max_v_rate_hz"):            read(r, limits.max_v_rate_hz); return true;
+        case key_hash("min_h_rate_khz"):           read(r, limits.min_h_rate_khz); return true;
+        case key_hash("min_v_rate_hz"):            read(r, limits.min_v_rate_hz); return true;
+        case key_hash("video_timing_support"):     read(r, limits.video_timing_support); return true;
+        default:                                   return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, AsciiString& ascii_string) {
+      switch (key) {
+        case key_hash("descriptor_type"): read(r, ascii_string.descriptor_type); return true;
+        case key_hash("string"):          ascii_string.string = r.string(); return true;
+        default:                          return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, EstablishedTimings3& established_timings_3) {
+      if (key != key_hash("established_timings_3"))
+        return false;
+
+      auto& bytes = established_timings_3.bytes_6_11;
+      r.array([&r, &bytes] {
+        const std::string_view name = r.string();
+        const bool known =
+          read_enum_bit<EstablishedTiming3Byte6>(name, bytes[0]) ||
+          read_enum_bit<EstablishedTiming3Byte7>(name, bytes[1]) ||
+          read_enum_bit<EstablishedTiming3Byte8>(name, bytes[2]) ||
+          read_enum_bit<EstablishedTiming3Byte9>(name, bytes[3]) ||
+          read_enum_bit<EstablishedTiming3Byte10>(name, bytes[4]) ||
+          read_enum_bit<EstablishedTiming3Byte11>(name, bytes[5]);
+        if (!known)
+          r.fail("unknown enumerator");
+      });
+      return true;
+    }
+
+    // Null is read like from_json() does, as a default-constructed descriptor
+    void read(JsonReader& r, EighteenByteDescriptor& descriptor) {
+      if (r.null())
+        descriptor = EighteenByteDescriptor{};
+      else
+        read_variant<DummyDescriptor>(r, descriptor);
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, ManufactureDate& date) {
+      switch (key) {
+        case key_hash("week_of_manufacture"): read(r, date.week_of_manufacture); return true;
+        case key_hash("year_of_manufacture"): read(r, date.year_of_manufacture); return true;
+        default:                              return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, ModelYear& year) {
+      switch (key) {
+        case key_hash("model_year"): read(r, year.model_year); return true;
+        default:                     return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, StandardTiming& timing) {
+      switch (key) {
+        case key_hash("aspect_ratio"): read(r, timing.aspect_ratio); return true;
+        case key_hash("v_frequency"):  read(r, timing.v_frequency); return true;
+        case key_hash("x_resolution"): read(r, timing.x_resolution); return true;
+        default:                       return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, BaseBlock& base_block) {
+      switch (key) {
+        case key_hash("bit_depth"):
+          read(r, base_block.bits_per_color);
+          return true;
+        case key_hash("chromaticity"):
+          read_fixed_array(r, base_block.chromaticity, [&r](uint8_t& byte) { read(r, byte); });
+          return true;
+        case key_hash("continuous_timings"):
+          read(r, base_block.continuous_timings);
+          return true;
+        case key_hash("digital_display_type"):
+          read(r, base_block.display_type);
+          return true;
+        case key_hash("dpms_active_off"):
+          read(r, base_block.dpms_active_off);
+          return true;
+        case key_hash("dpms_standby"):
+          read(r, base_block.dpms_standby);
+          return true;
+        case key_hash("dpms_suspend"):
+          read(r, base_block.dpms_suspend);
+          return true;
+        case key_hash("edid_major_version"):
+          read(r, base_block.edid_major_version);
+          return true;
+        case key_hash("edid_minor_version"):
+          read(r, base_block.edid_minor_version);
+          return true;
+        case key_hash("eighteen_byte_descriptors"):
+          read_fixed_array(r, base_block.eighteen_byte_descriptors,
+            [&r](EighteenByteDescriptor& descriptor) { read(r, descriptor); });
+          return true;
+        case key_hash("established_timings_1"):
+          read_enum_array<EstablishedTiming1>(r, base_block.established_timings_1);
+          return true;
+        case key_hash("established_timings_2"):
+          read_enum_array<EstablishedTiming2>(r, base_block.established_timings_2);
+          return true;
+        case key_hash("gamma"):
+          read(r, base_block.gamma);
+          return true;
+        case key_hash("h_screen_size"):
+          read(r, base_block.h_screen_size);
+          return true;
+        case key_hash("manufacture_date_or_model_year"):
+          read_variant<ManufactureDate>(r, base_block.manufacture_date_or_model_year);
+          return true;
+        case key_hash("manufacturer_id"): {
+          const std::string_view manufacturer_id = r.string();
+          if (manufacturer_id.size() < base_block.manufacturer_id.size())
+            r.fail("manufacturer_id is too short");
+          std::copy_n(manufacturer_id.begin(), base_block.manufacturer_id.size(), base_block.manufacturer_id.begin());
+          return true;
+        }
+        case key_hash("manufacturers_timings"):
+          read_enum_array<ManufacturersTiming>(r, base_block.manufacturers_timings);
+          return true;
+        case key_hash("preferred_timing_mode"):
+          read(r, base_block.preferred_timing_mode);
+          return true;
+        case key_hash("product_code"):
+          read(r, base_block.product_code);
+          return true;
+        case key_hash("serial_number"):
+          read(r, base_block.serial_number);
+          return true;
+        case key_hash("srgb_is_primary"):
+          read(r, base_block.standard_srgb);
+          return true;
+        case key_hash("standard_timings"):
+          read_fixed_array(r, base_block.standard_timings,
+            [&r](std::optional<StandardTiming>& timing) { read_object(r, timing.emplace()); });
+          return true;
+        case key_hash("v_screen_size"):
+          read(r, base_block.v_screen_size);
+          return true;
+        case key_hash("video_interface"):
+          read(r, base_block.video_interface);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    // CTA Data Blocks
+
+    bool read_member(JsonReader& r, uint64_t key, UnknownDataBlock& block) {
+      switch (key) {
+        case key_hash("data_block_tag"): read(r, block.data_block_tag); return true;
+        case key_hash("extended_tag"):   read(r, block.extended_tag); return true;
+        case key_hash("raw_data"):       read_number_array(r, block.raw_data); return true;
+        default:                         return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, VideoDataBlock& block) {
+      switch (key) {
+        case key_hash("vics"): read_number_array(r, block.vics); return true;
+        default:               return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, ShortAudioDescriptor& sad) {
+      switch (key) {
+        case key_hash("audio_format"):
+          read(r, sad.audio_format);
+          return true;
+        case key_hash("channels"): {
+          uint8_t channels;
+          read(r, channels);
+          sad.channels = AudioChannels(channels - 1);
+          return true;
+        }
+        case key_hash("lpcm_bit_depths"):
+          r.array([&r, &sad] {
+            uint8_t depth;
+            read(r, depth);
+            switch (depth) {
+              case 24:
+                sad.lpcm_bit_depths |= LpcmBitDepth::LPCM_BD_24;
+                break;
+              case 20:
+                sad.lpcm_bit_depths |= LpcmBitDepth::LPCM_BD_20;
+                break;
+              case 16:
+                sad.lpcm_bit_depths |= LpcmBitDepth::LPCM_BD_16;
+                break;
+            }
+          });
+          return true;
+        case key_hash("sampling_freqs"):
+          read_enum_array<SamplingFrequence>(r, sad.sampling_freqs);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, AudioDataBlock& block) {
+      if (key != key_hash("sads"))
+        return false;
+      r.array([&r, &block] {
+        read_object(r, block.sads.emplace_back());
+      });
+      return true;
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, SpeakerAllocationDataBlock& block) {
+      switch (key) {
+        case key_hash("speaker_allocation"): read_enum_array<Speaker>(r, block.speaker_allocation); return true;
+        default:                             return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, YCbCr420CapabilityMapDataBlock& block) {
+      switch (key) {
+        case key_hash("ycbcr420_capability_map"): read_number_array(r, block.svd_indices); return true;
+        default:                                  return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, StereoVideoSupport& support) {
+      switch (key) {
+        case key_hash("formats"): {
+          // Formats without bits are written as null
+          std::pair<uint8_t, uint8_t>& formats = support.formats.emplace();
+          if (r.null())
+            return true;
+          r.array([&r, &formats] {
+            const std::string_view name = r.string();
+            const bool known =
+              read_enum_bit<StereoVideoFormatByte1>(name, formats.first) ||
+              read_enum_bit<StereoVideoFormatByte2>(name, formats.second);
+            if (!known)
+              r.fail("unknown enumerator");
+          });
+          return true;
+        }
+        case key_hash("vics"): {
+          uint16_t& vics = support.vics.emplace();
+          r.array([&r, &vics] {
+            uint8_t vic;
+            read(r, vic);
+            if (vic < 1 || vic > 16)
+              r.fail("3D VIC is out of 1..16");
+            vics |= 1 << (vic - 1);
+          });
+          return true;
+        }
+        default:
+          return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, Vic3dSupport& support) {
+      switch (key) {
+        case key_hash("format"):         read(r, support.format); return true;
+        case key_hash("subsampling_3d"): read(r, support.subsampling_3d); return true;
+        case key_hash("vic_index"):      read(r, support.vic_index); return true;
+        default:                         return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, HdmiVideoSubblock& block) {
+      switch (key) {
+        case key_hash("hdmi_vics"):
+          read_number_array(r, block.hdmi_vics);
+          return true;
+        case key_hash("image_size_meaning"):
+          read(r, block.image_size_meaning);
+          return true;
+        case key_hash("stereo_video_support"): {
+          // Null is read like from_json() does, as support of nothing
+          StereoVideoSupport& support = block.stereo_video_support.emplace();
+          if (!r.null())
+            read_object(r, support);
+          return true;
+        }
+        case key_hash("vic_3d_support"):
+          r.array([&r, &block] {
+            read_object(r, block.vic_3d_support.emplace_back());
+          });
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    void read_latency(JsonReader& r, std::optional<std::pair<uint8_t, uint8_t>>& latency) {
+      std::pair<uint8_t, uint8_t>& value = latency.emplace();
+      r.object([&r, &value](uint64_t key) {
+        switch (key) {
+          case key_hash("audio"): read(r, value.second); break;
+          case key_hash("video"): read(r, value.first); break;
+          default:                r.skip();
+        }
+      });
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, HdmiVendorDataBlock& block) {
+      if (key != key_hash("hdmi_vsdb"))
+        return false;
+
+      r.object([&r, &block](uint64_t key) {
+        switch (key) {
+          case key_hash("capabilities"):
+            read_enum_array<HdmiVendorDataBlockByte6Flags>(r, block.capabilities.emplace());
+            break;
+          case key_hash("content_types"):
+            read_enum_array<ContentType>(r, block.content_types);
+            break;
+          case key_hash("hdmi_video"):
+            read_object(r, block.hdmi_video.emplace());
+            break;
+          case key_hash("interlaced_latency"):
+            read_latency(r, block.interlaced_latency);
+            break;
+          case key_hash("latency"):
+            read_latency(r, block.latency);
+            break;
+          case key_hash("max_tmds_clock_mhz"):
+            read(r, block.max_tmds_clock_mhz);
+            break;
+          case key_hash("source_phy_addr"):
+            read_fixed_array(r, block.source_phy_addr, [&r](uint8_t& byte) { read(r, byte); });
+            break;
+          default:
+            r.skip();
+        }
+      });
+      return true;
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, HdrStaticMetadataDataBlock& block) {
+      switch (key) {
+        case key_hash("max_frame_average_luminance_code_value"):
+          read(r, block.max_frame_average_luminance_code_value);
+          return true;
+        case key_hash("max_luminance_code_value"):
+          read(r, block.max_luminance_code_value);
+          return true;
+        case key_hash("min_luminance_code_value"):
+          read(r, block.min_luminance_code_value);
+          return true;
+        case key_hash("static_metadata_types"):
+          read_enum_array<StaticMetadataType>(r, block.static_metadata_types);
+          return true;
+        case key_hash("transfer_functions"):
+          read_enum_array<ElectroOpticalTransferFunction>(r, block.transfer_functions);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, VideoCapabilityDataBlock& block) {
+      switch (key) {
+        case key_hash("ce_scan_behaviour"):
+          read(r, block.ce_scan_behaviour);
+          return true;
+        case key_hash("is_rgb_quantization_range_selectable"):
+          read(r, block.is_rgb_quantization_range_selectable);
+          return true;
+        case key_hash("is_ycc_quantization_range_selectable"):
+          read(r, block.is_ycc_quantization_range_selectable);
+          return true;
+        case key_hash("it_scan_behaviour"):
+          read(r, block.it_scan_behaviour);
+          return true;
+        case key_hash("pt_scan_behaviour"):
+          read(r, block.pt_scan_behaviour);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, ColorimetryDataBlock& block) {
+      switch (key) {
+        case key_hash("colorimetry_standards"):
+          read_enum_array<ColorimetryStandard>(r, block.colorimetry_standards);
+          return true;
+        case key_hash("gamut_metadata_profiles"):
+          read_enum_array<GamutMetadataProfile>(r, block.gamut_metadata_profiles);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    // Null is read like from_json() does, as a default-constructed data block
+    void read(JsonReader& r, CtaDataBlock& data_block) {
+      if (r.null())
+        data_block = CtaDataBlock{};
+      else
+        read_variant<CtaDataBlock>(r, data_block);
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, Cta861Block& block) {
+      switch (key) {
+        case key_hash("basic_audio"):
+          read(r, block.basic_audio);
+          return true;
+        case key_hash("data_block_collection"):
+          r.array([&r, &block] {
+            read(r, block.data_block_collection.emplace_back());
+          });
+          return true;
+        case key_hash("detailed_timing_descriptors"):
+          r.array([&r, &block] {
+            read_object(r, block.detailed_timing_descriptors.emplace_back());
+          });
+          return true;
+        case key_hash("underscan"):
+          read(r, block.underscan);
+          return true;
+        case key_hash("ycbcr_422"):
+          read(r, block.ycbcr_422);
+          return true;
+        case key_hash("ycbcr_444"):
+          read(r, block.ycbcr_444);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    bool read_member(JsonReader& r, uint64_t key, EdidData& edid) {
+      switch (key) {
+        case key_hash("base_block"):
+          read_object(r, edid.base_block);
+          return true;
+        case key_hash("extension_blocks"):
+          if (r.null()) {
+            edid.extension_blocks.reset();
+            return true;
+          }
+          {
+            std::vector<Cta861Block>& extension_blocks = edid.extension_blocks.emplace();
+            r.array([&r, &extension_blocks] {
+              read_object(r, extension_blocks.emplace_back());
+            });
+          }
+          return true;
+        default:
+          return false;
+      }
+    }
+  }  // namespace
+
+  EdidData read_edid_json(const char* data, size_t size) {
+    JsonReader reader(data, size);
+    EdidData edid;
+    read_object(reader, edid);
+    reader.end();
+    return edid;
+  }
+
+  EdidData read_edid_json(const std::string& text) {
+    return read_edid_json(text.data(), text.size());
+  }
+}  // namespace Edid
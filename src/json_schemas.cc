@@ -1,15 +1,93 @@
 // Copyright 2023 N-Nagorny
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
 #include "edid/json_schemas.hh"
 
 namespace Edid {
   namespace json_schemas {
+    namespace {
+      struct Schema {
+        explicit Schema(const char* const* source) : source(source) {}
+
+        const char* const* source;  // Auto-generated constant
+        std::once_flag parsed_flag;
+        json parsed;
+        std::once_flag compiled_flag;
+        std::unique_ptr<nlohmann::json_schema::json_validator> validator;
+      };
+
+      // Registry of all embedded schemas, which get parsed and compiled on demand
+      Schema& find_schema(const json_uri& uri) {
+        static std::map<json_uri, Schema> registry = [] {
+          const std::pair<const char*, const char* const*> sources[] = {
+            { "base_block.json", &base_block::base_block },
+            { "standard_timing.json", &base_block::standard_timing },
+
+            { "ascii_string.json", &common::ascii_string },
+            { "detailed_timing_descriptor.json", &common::detailed_timing_descriptor },
+            { "edid.json", &common::edid },
+            { "display_range_limits.json", &common::display_range_limits },
+            { "established_timings_3.json", &common::established_timings_3 },
+
+            { "audio_data_block.json", &cta861_block::audio_data_block },
+            { "colorimetry_data_block.json", &cta861_block::colorimetry_data_block },
+            { "cta861_block.json", &cta861_block::cta861_block },
+            { "hdmi_vsdb.json", &cta861_block::hdmi_vsdb },
+            { "hdr_static_metadata_data_block.json", &cta861_block::hdr_static_metadata_data_block },
+            { "speaker_allocation_data_block.json", &cta861_block::speaker_allocation_data_block },
+            { "unknown_data_block.json", &cta861_block::unknown_data_block },
+            { "video_capability_data_block.json", &cta861_block::video_capability_data_block },
+            { "video_data_block.json", &cta861_block::video_data_block },
+            { "ycbcr420_capability_map_data_block.json", &cta861_block::ycbcr420_capability_map_data_block },
+          };
+
+          std::map<json_uri, Schema> result;
+          for (const auto& [uri, source] : sources) {
+            result.emplace(std::piecewise_construct, std::forward_as_tuple(uri), std::forward_as_tuple(source));
+          }
+          return result;
+        }();
+
+        auto found = registry.find(uri);
+        if (found == registry.end()) {
+          throw std::runtime_error("JSON Schema not found for " + uri.to_string());
+        }
+        return found->second;
+      }
+    }  // namespace
+
+    const json& get_schema(const json_uri& uri) {
+      Schema& schema = find_schema(uri);
+      std::call_once(schema.parsed_flag, [&schema] {
+        schema.parsed = json::parse(*schema.source);
+      });
+      return schema.parsed;
+    }
+
+    void schema_loader(const json_uri& id, json& value) {
+      value = get_schema(id);
+    }
+
+    const nlohmann::json_schema::json_validator& get_validator(const std::string& uri) {
+      const json_uri schema_uri{uri};
+      Schema& schema = find_schema(schema_uri);
+      std::call_once(schema.compiled_flag, [&schema, &schema_uri] {
+        schema.validator = std::make_unique<nlohmann::json_schema::json_validator>(
+          get_schema(schema_uri),
+          schema_loader
+        );
+      });
+      return *schema.validator;
+    }
+
     bool is_json_satisfies_schema(const std::string& uri, const nlohmann::json& j) {
       try {
-        nlohmann::json_schema::json_validator validator{
-          schemas.at(nlohmann::json_uri{uri}),
-          schema_loader
-        };
-        validator.validate(j);
+        get_validator(uri).validate(j);
       } catch (const std::exception &e) {
         return false;
       }
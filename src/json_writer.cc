@@ -0,0 +1,647 @@
+// Copyright 2023 N-Nagorny
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <variant>
+
+#include "edid/json_writer.hh"
+
+// Members of every object are written in the order of sorted keys, as nlohmann::json
+// keeps them in std::map. Where to_json() of src/json.cc leaves a value null or omits
+// a key, so do the writers below.
+
+namespace Edid {
+  namespace {
+    class JsonWriter {
+     public:
+      JsonWriter(std::string& out, int indent)
+        : out_(out)
+        , indent_(indent)
+      {}
+
+      void begin_object() { begin_container('{'); }
+      void end_object() { end_container('}'); }
+      void begin_array() { begin_container('['); }
+      void end_array() { end_container(']'); }
+
+      void key(const char* key) {
+        separate();
+        write_string(key);
+        out_ += indent_ >= 0 ? ": " : ":";
+        after_key_ = true;
+      }
+
+      void null() {
+        begin_value();
+        out_ += "null";
+      }
+
+      void value(bool value) {
+        begin_value();
+        out_ += value ? "true" : "false";
+      }
+
+      void value(uint64_t value) {
+        begin_value();
+        char buffer[20];
+        out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+      }
+
+      void value(const std::string& value) {
+        begin_value();
+        write_string(value);
+      }
+
+      template <class T>
+      void value(const std::optional<T>& value) {
+        if (value.has_value())
+          this->value(*value);
+        else
+          null();
+      }
+
+     private:
+      void begin_value() {
+        if (after_key_)
+          after_key_ = false;
+        else if (depth_ > 0)
+          separate();
+      }
+
+      // Puts a comma and a line break before all but the first member of a container
+      void separate() {
+        if (!first_)
+          out_ += ',';
+        first_ = false;
+        newline();
+      }
+
+      void begin_container(char bracket) {
+        begin_value();
+        out_ += bracket;
+        first_ = true;
+        ++depth_;
+      }
+
+      void end_container(char bracket) {
+        --depth_;
+        // Empty containers stay on one line
+        if (!first_)
+          newline();
+        first_ = false;
+        out_ += bracket;
+      }
+
+      void newline() {
+        if (indent_ >= 0) {
+          out_ += '\n';
+          out_.append(depth_ * indent_, ' ');
+        }
+      }
+
+      // Escapes the same characters as nlohmann::json::dump() with ensure_ascii == false
+      void write_string(const std::string& value) {
+        out_ += '"';
+        for (char c : value) {
+          switch (c) {
+            case '"':  out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default:
+              if (static_cast<uint8_t>(c) <= 0x1F) {
+                char buffer[7];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<uint8_t>(c));
+                out_ += buffer;
+              }
+              else {
+                out_ += c;
+              }
+          }
+        }
+        out_ += '"';
+      }
+
+      std::string& out_;
+      const int indent_;
+      int depth_ = 0;
+      bool first_ = true;  // No member has been written into the innermost container yet
+      bool after_key_ = false;
+    };
+
+    template <class E, class T>
+    void write_enum_array(JsonWriter& w, T bitfield) {
+      w.begin_array();
+      for (E e : bitfield_to_enums<E>(bitfield))
+        w.value(to_string(e));
+      w.end_array();
+    }
+
+    template <class Container>
+    void write_number_array(JsonWriter& w, const Container& numbers) {
+      w.begin_array();
+      for (auto number : numbers)
+        w.value(static_cast<uint64_t>(number));
+      w.end_array();
+    }
+
+    // Base Block
+
+    void write(JsonWriter& w, const AnalogCompositeSync& sync) {
+      w.begin_object();
+      w.key("bipolar");
+      w.value(sync.bipolar);
+      w.key("serrations");
+      w.value(sync.serrations);
+      w.key("sync_on_rgb_signals");
+      w.value(sync.sync_on_rgb_signals);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const DigitalCompositeSync& sync) {
+      w.begin_object();
+      w.key("h_sync_polarity");
+      w.value(sync.h_sync_polarity);
+      w.key("serrations");
+      w.value(sync.serrations);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const DigitalSeparateSync& sync) {
+      w.begin_object();
+      w.key("h_sync_polarity");
+      w.value(sync.h_sync_polarity);
+      w.key("v_sync_polarity");
+      w.value(sync.v_sync_polarity);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const DetailedTimingDescriptor& dtd) {
+      w.begin_object();
+      w.key("h_blanking");
+      w.value(uint64_t{dtd.h_blanking});
+      w.key("h_border");
+      w.value(uint64_t{dtd.h_border_pixels});
+      w.key("h_front_porch");
+      w.value(uint64_t{dtd.h_front_porch});
+      w.key("h_image_size");
+      w.value(uint64_t{dtd.h_image_size});
+      w.key("h_res");
+      w.value(uint64_t{dtd.h_res});
+      w.key("h_sync_width");
+      w.value(uint64_t{dtd.h_sync_width});
+      w.key("interlaced");
+      w.value(dtd.features_bitmap.interlaced);
+      w.key("pixel_clock_khz");
+      w.value(uint64_t{dtd.pixel_clock_hz / 1'000});
+      w.key("stereo_mode");
+      w.value(to_string(dtd.features_bitmap.stereo_mode));
+      w.key("sync");
+      std::visit([&w](const auto& sync) { write(w, sync); }, dtd.features_bitmap.sync);
+      w.key("v_blanking");
+      w.value(uint64_t{dtd.v_blanking});
+      w.key("v_border");
+      w.value(uint64_t{dtd.v_border_lines});
+      w.key("v_front_porch");
+      w.value(uint64_t{dtd.v_front_porch});
+      w.key("v_image_size");
+      w.value(uint64_t{dtd.v_image_size});
+      w.key("v_res");
+      w.value(uint64_t{dtd.v_res});
+      w.key("v_sync_width");
+      w.value(uint64_t{dtd.v_sync_width});
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const DummyDescriptor&) {
+      w.begin_object();
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const DisplayRangeLimits& limits) {
+      w.begin_object();
+      w.key("max_h_rate_khz");
+      w.value(uint64_t{limits.max_h_rate_khz});
+      w.key("max_pixel_clock_rate_mhz");
+      w.value(uint64_t{limits.max_pixel_clock_rate_mhz});
+      w.key("max_v_rate_hz");
+      w.value(uint64_t{limits.max_v_rate_hz});
+      w.key("min_h_rate_khz");
+      w.value(uint64_t{limits.min_h_rate_khz});
+      w.key("min_v_rate_hz");
+      w.value(uint64_t{limits.min_v_rate_hz});
+      w.key("video_timing_support");
+      w.value(to_string(limits.video_timing_support));
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const AsciiString& ascii_string) {
+      w.begin_object();
+      w.key("descriptor_type");
+      w.value(to_string(ascii_string.descriptor_type));
+      w.key("string");
+      w.value(ascii_string.string);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const EstablishedTimings3& established_timings_3) {
+      const auto& bytes = established_timings_3.bytes_6_11;
+      if (std::all_of(bytes.begin(), bytes.end(), [](uint8_t byte) { return byte == 0; })) {
+        w.null();
+        return;
+      }
+
+      w.begin_object();
+      w.key("established_timings_3");
+      w.begin_array();
+      for (EstablishedTiming3Byte6 et : bitfield_to_enums<EstablishedTiming3Byte6>(bytes.at(0)))
+        w.value(to_string(et));
+      for (EstablishedTiming3Byte7 et : bitfield_to_enums<EstablishedTiming3Byte7>(bytes.at(1)))
+        w.value(to_string(et));
+      for (EstablishedTiming3Byte8 et : bitfield_to_enums<EstablishedTiming3Byte8>(bytes.at(2)))
+        w.value(to_string(et));
+      for (EstablishedTiming3Byte9 et : bitfield_to_enums<EstablishedTiming3Byte9>(bytes.at(3)))
+        w.value(to_string(et));
+      for (EstablishedTiming3Byte10 et : bitfield_to_enums<EstablishedTiming3Byte10>(bytes.at(4)))
+        w.value(to_string(et));
+      for (EstablishedTiming3Byte11 et : bitfield_to_enums<EstablishedTiming3Byte11>(bytes.at(5)))
+        w.value(to_string(et));
+      w.end_array();
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const ManufactureDate& date) {
+      w.begin_object();
+      w.key("week_of_manufacture");
+      w.value(uint64_t{date.week_of_manufacture});
+      w.key("year_of_manufacture");
+      w.value(uint64_t{date.year_of_manufacture});
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const ModelYear& year) {
+      w.begin_object();
+      w.key("model_year");
+      w.value(uint64_t{year.model_year});
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const StandardTiming& timing) {
+      w.begin_object();
+      w.key("aspect_ratio");
+      w.value(to_string(timing.aspect_ratio));
+      w.key("v_frequency");
+      w.value(uint64_t{timing.v_frequency});
+      w.key("x_resolution");
+      w.value(uint64_t{timing.x_resolution});
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const BaseBlock& base_block) {
+      w.begin_object();
+      w.key("bit_depth");
+      w.value(to_string(base_block.bits_per_color));
+      w.key("chromaticity");
+      write_number_array(w, base_block.chromaticity);
+      w.key("continuous_timings");
+      w.value(base_block.continuous_timings);
+      w.key("digital_display_type");
+      w.value(to_string(base_block.display_type));
+      w.key("dpms_active_off");
+      w.value(base_block.dpms_active_off);
+      w.key("dpms_standby");
+      w.value(base_block.dpms_standby);
+      w.key("dpms_suspend");
+      w.value(base_block.dpms_suspend);
+      w.key("edid_major_version");
+      w.value(uint64_t{base_block.edid_major_version});
+      w.key("edid_minor_version");
+      w.value(uint64_t{base_block.edid_minor_version});
+      w.key("eighteen_byte_descriptors");
+      w.begin_array();
+      for (const auto& descriptor : base_block.eighteen_byte_descriptors)
+        std::visit([&w](const auto& d) { write(w, d); }, descriptor);
+      w.end_array();
+      w.key("established_timings_1");
+      write_enum_array<EstablishedTiming1>(w, base_block.established_timings_1);
+      w.key("established_timings_2");
+      write_enum_array<EstablishedTiming2>(w, base_block.established_timings_2);
+      w.key("gamma");
+      w.value(uint64_t{base_block.gamma});
+      w.key("h_screen_size");
+      w.value(uint64_t{base_block.h_screen_size});
+      w.key("manufacture_date_or_model_year");
+      std::visit([&w](const auto& d) { write(w, d); }, base_block.manufacture_date_or_model_year);
+      w.key("manufacturer_id");
+      w.value(std::string(base_block.manufacturer_id.begin(), base_block.manufacturer_id.end()));
+      w.key("manufacturers_timings");
+      write_enum_array<ManufacturersTiming>(w, base_block.manufacturers_timings);
+      w.key("preferred_timing_mode");
+      w.value(base_block.preferred_timing_mode);
+      w.key("product_code");
+      w.value(uint64_t{base_block.product_code});
+      w.key("serial_number");
+      w.value(uint64_t{base_block.serial_number});
+      w.key("srgb_is_primary");
+      w.value(base_block.standard_srgb);
+      w.key("standard_timings");
+      w.begin_array();
+      for (const auto& timing : base_block.standard_timings) {
+        if (timing.has_value())
+          write(w, *timing);
+      }
+      w.end_array();
+      w.key("v_screen_size");
+      w.value(uint64_t{base_block.v_screen_size});
+      w.key("video_interface");
+      w.value(to_string(base_block.video_interface));
+      w.end_object();
+    }
+
+    // CTA Data Blocks
+
+    void write(JsonWriter& w, const UnknownDataBlock& block) {
+      w.begin_object();
+      w.key("data_block_tag");
+      w.value(uint64_t{block.data_block_tag});
+      w.key("extended_tag");
+      w.value(block.extended_tag.has_value() ? std::optional<uint64_t>(*block.extended_tag) : std::nullopt);
+      w.key("raw_data");
+      write_number_array(w, block.raw_data);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const VideoDataBlock& block) {
+      w.begin_object();
+      w.key("vics");
+      write_number_array(w, block.vics);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const ShortAudioDescriptor& sad) {
+      w.begin_object();
+      w.key("audio_format");
+      w.value(to_string(sad.audio_format));
+      w.key("channels");
+      w.value(uint64_t{sad.channels + 1u});
+      // Reserved bits alone give no bit depths, so the key is omitted like to_json() does
+      if (sad.lpcm_bit_depths & (LPCM_BD_24 | LPCM_BD_20 | LPCM_BD_16)) {
+        w.key("lpcm_bit_depths");
+        w.begin_array();
+        for (LpcmBitDepth depth : bitfield_to_enums<LpcmBitDepth>(sad.lpcm_bit_depths)) {
+          switch (depth) {
+            case LPCM_BD_24:
+              w.value(uint64_t{24});
+              break;
+            case LPCM_BD_20:
+              w.value(uint64_t{20});
+              break;
+            case LPCM_BD_16:
+              w.value(uint64_t{16});
+              break;
+          }
+        }
+        w.end_array();
+      }
+      w.key("sampling_freqs");
+      write_enum_array<SamplingFrequence>(w, sad.sampling_freqs);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const AudioDataBlock& block) {
+      w.begin_object();
+      w.key("sads");
+      w.begin_array();
+      for (const auto& sad : block.sads)
+        write(w, sad);
+      w.end_array();
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const SpeakerAllocationDataBlock& block) {
+      if (bitfield_to_enums<Speaker>(block.speaker_allocation).empty()) {
+        w.null();
+        return;
+      }
+      w.begin_object();
+      w.key("speaker_allocation");
+      write_enum_array<Speaker>(w, block.speaker_allocation);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const YCbCr420CapabilityMapDataBlock& block) {
+      if (block.svd_indices.empty()) {
+        w.null();
+        return;
+      }
+      w.begin_object();
+      w.key("ycbcr420_capability_map");
+      write_number_array(w, block.svd_indices);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const StereoVideoSupport& support) {
+      const bool has_vics = support.vics.has_value() && *support.vics != 0;
+      if (!support.formats.has_value() && !has_vics) {
+        w.null();
+        return;
+      }
+
+      w.begin_object();
+      if (support.formats.has_value()) {
+        w.key("formats");
+        const auto& [byte_1, byte_2] = *support.formats;
+        if (byte_1 == 0 && byte_2 == 0) {
+          w.null();
+        }
+        else {
+          w.begin_array();
+          for (StereoVideoFormatByte1 format : bitfield_to_enums<StereoVideoFormatByte1>(byte_1))
+            w.value(to_string(format));
+          for (StereoVideoFormatByte2 format : bitfield_to_enums<StereoVideoFormatByte2>(byte_2))
+            w.value(to_string(format));
+          w.end_array();
+        }
+      }
+      if (has_vics) {
+        w.key("vics");
+        w.begin_array();
+        for (int i = 0; i < 16; ++i) {
+          if (*support.vics >> i & BITMASK_TRUE(1))
+            w.value(uint64_t(i + 1));
+        }
+        w.end_array();
+      }
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const Vic3dSupport& support) {
+      w.begin_object();
+      w.key("format");
+      w.value(to_string(support.format));
+      if (support.subsampling_3d.has_value()) {
+        w.key("subsampling_3d");
+        w.value(to_string(*support.subsampling_3d));
+      }
+      w.key("vic_index");
+      w.value(uint64_t{support.vic_index});
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const HdmiVideoSubblock& block) {
+      w.begin_object();
+      w.key("hdmi_vics");
+      write_number_array(w, block.hdmi_vics);
+      w.key("image_size_meaning");
+      w.value(to_string(block.image_size_meaning));
+      if (block.stereo_video_support.has_value()) {
+        w.key("stereo_video_support");
+        write(w, *block.stereo_video_support);
+      }
+      w.key("vic_3d_support");
+      w.begin_array();
+      for (const auto& support : block.vic_3d_support)
+        write(w, support);
+      w.end_array();
+      w.end_object();
+    }
+
+    void write_latency(JsonWriter& w, const std::pair<uint8_t, uint8_t>& latency) {
+      w.begin_object();
+      w.key("audio");
+      w.value(uint64_t{latency.second});
+      w.key("video");
+      w.value(uint64_t{latency.first});
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const HdmiVendorDataBlock& block) {
+      w.begin_object();
+      w.key("hdmi_vsdb");
+      w.begin_object();
+      if (block.capabilities.has_value() && !bitfield_to_enums<HdmiVendorDataBlockByte6Flags>(*block.capabilities).empty()) {
+        w.key("capabilities");
+        write_enum_array<HdmiVendorDataBlockByte6Flags>(w, *block.capabilities);
+      }
+      w.key("content_types");
+      write_enum_array<ContentType>(w, block.content_types);
+      if (block.hdmi_video.has_value()) {
+        w.key("hdmi_video");
+        write(w, *block.hdmi_video);
+      }
+      if (block.interlaced_latency.has_value()) {
+        w.key("interlaced_latency");
+        write_latency(w, *block.interlaced_latency);
+      }
+      if (block.latency.has_value()) {
+        w.key("latency");
+        write_latency(w, *block.latency);
+      }
+      if (block.max_tmds_clock_mhz.has_value()) {
+        w.key("max_tmds_clock_mhz");
+        w.value(uint64_t{*block.max_tmds_clock_mhz});
+      }
+      w.key("source_phy_addr");
+      write_number_array(w, block.source_phy_addr);
+      w.end_object();
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const HdrStaticMetadataDataBlock& block) {
+      const auto optional_number = [](const std::optional<uint8_t>& value) {
+        return value.has_value() ? std::optional<uint64_t>(*value) : std::nullopt;
+      };
+
+      w.begin_object();
+      w.key("max_frame_average_luminance_code_value");
+      w.value(optional_number(block.max_frame_average_luminance_code_value));
+      w.key("max_luminance_code_value");
+      w.value(optional_number(block.max_luminance_code_value));
+      w.key("min_luminance_code_value");
+      w.value(optional_number(block.min_luminance_code_value));
+      w.key("static_metadata_types");
+      write_enum_array<StaticMetadataType>(w, block.static_metadata_types);
+      w.key("transfer_functions");
+      write_enum_array<ElectroOpticalTransferFunction>(w, block.transfer_functions);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const VideoCapabilityDataBlock& block) {
+      w.begin_object();
+      w.key("ce_scan_behaviour");
+      w.value(to_string(block.ce_scan_behaviour));
+      w.key("is_rgb_quantization_range_selectable");
+      w.value(block.is_rgb_quantization_range_selectable);
+      w.key("is_ycc_quantization_range_selectable");
+      w.value(block.is_ycc_quantization_range_selectable);
+      w.key("it_scan_behaviour");
+      w.value(to_string(block.it_scan_behaviour));
+      w.key("pt_scan_behaviour");
+      w.value(to_string(block.pt_scan_behaviour));
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const ColorimetryDataBlock& block) {
+      w.begin_object();
+      w.key("colorimetry_standards");
+      write_enum_array<ColorimetryStandard>(w, block.colorimetry_standards);
+      w.key("gamut_metadata_profiles");
+      write_enum_array<GamutMetadataProfile>(w, block.gamut_metadata_profiles);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const Cta861Block& block) {
+      w.begin_object();
+      w.key("basic_audio");
+      w.value(block.basic_audio);
+      w.key("data_block_collection");
+      w.begin_array();
+      for (const CtaDataBlock& data_block : block.data_block_collection)
+        std::visit([&w](const auto& d) { write(w, d); }, data_block);
+      w.end_array();
+      w.key("detailed_timing_descriptors");
+      w.begin_array();
+      for (const auto& timing : block.detailed_timing_descriptors)
+        write(w, timing);
+      w.end_array();
+      w.key("underscan");
+      w.value(block.underscan);
+      w.key("ycbcr_422");
+      w.value(block.ycbcr_422);
+      w.key("ycbcr_444");
+      w.value(block.ycbcr_444);
+      w.end_object();
+    }
+
+    void write(JsonWriter& w, const EdidData& edid) {
+      w.begin_object();
+      w.key("base_block");
+      write(w, edid.base_block);
+      if (edid.extension_blocks.has_value()) {
+        w.key("extension_blocks");
+        w.begin_array();
+        for (const auto& ext_block : *edid.extension_blocks)
+          write(w, ext_block);
+        w.end_array();
+      }
+      w.end_object();
+    }
+  }  // namespace
+
+  void write_edid_json(const EdidData& edid, std::string& out, int indent) {
+    JsonWriter writer(out, indent);
+    write(writer, edid);
+  }
+
+  void write_edid_json(const EdidData& edid, std::ostream& os, int indent) {
+    std::string out;
+    write_edid_json(edid, out, indent);
+    os.write(out.data(), out.size());
+  }
+}  // namespace Edid
@@ -0,0 +1,39 @@
+// Copyright 2023 N-Nagorny
+#include <string>
+
+#include "edid/parse_result.hh"
+
+namespace Edid {
+  std::string ParseError::message() const {
+    std::string result = "Block " + std::to_string(block_index) +
+      ", byte " + std::to_string(byte_offset) + ": ";
+
+    switch (code) {
+      case PE_INVALID_SIZE:
+        return result + "EDID size " + std::to_string(value) +
+          " is not a factor of " + std::to_string(EDID_BLOCK_SIZE);
+      case PE_TRUNCATED:
+        return result + "EDID Base Block announces " + std::to_string(value) +
+          " extension blocks which are not present";
+      case PE_INVALID_HEADER:
+        return result + "EDID base block header is invalid.";
+      case PE_INVALID_CHECKSUM:
+        return result + "checksum " + std::to_string(value) + " is invalid.";
+      case PE_UNKNOWN_DISPLAY_DESCRIPTOR:
+        return result + "Display Descriptor has unknown Display Descriptor Type " + std::to_string(value);
+      case PE_INVALID_EXTENSION_TAG:
+        return result + "CTA Extension has invalid Extension Tag: " + std::to_string(value);
+      case PE_UNSUPPORTED_EXTENSION_VERSION:
+        return result + "CTA Extension has unsupported version: " + std::to_string(value);
+      case PE_INVALID_DTD_OFFSET:
+        return result + "CTA Extension has invalid DTD offset: " + std::to_string(value);
+      case PE_INVALID_DATA_BLOCK_LENGTH:
+        return result + "Data Block has invalid length: " + std::to_string(value);
+      case PE_DATA_BLOCK_OVERRUN:
+        return result + "Data Block Collection runs past DTD offset " + std::to_string(value);
+      case PE_MALFORMED:
+        return result + "EDID is malformed.";
+    }
+    return result + to_string(code);
+  }
+}  // namespace Edid
@@ -1,16 +1,28 @@
 // Copyright 2023 N-Nagorny
+#include <cstdlib>
+#include <functional>
+#include <initializer_list>
+#include <numeric>
+
 #include "edid/exceptions.hh"
 #include "edid/timing_modes.hh"
 
 namespace Edid {
+  static constexpr uint16_t pixel_repetition_factors(std::initializer_list<uint8_t> factors) {
+    uint16_t result = 0;
+    for (uint8_t factor : factors)
+      result |= 1 << (factor - 1);
+    return result;
+  }
+
   // Number
-  #define N(x) uint8_t(x)
+  #define N(x) pixel_repetition_factors({x})
   // Range
-  #define R(x, y) std::make_pair(x, y)
+  #define R(x, y) static_cast<uint16_t>((1 << (y)) - (1 << ((x) - 1)))
   // Vector
-  #define V(...) std::vector<uint8_t>{__VA_ARGS__}
+  #define V(...) pixel_repetition_factors({__VA_ARGS__})
 
-  static const std::vector<Cta861VideoTimingMode> cta_modes_1 = {
+  static constexpr Cta861VideoTimingMode cta_modes_1[] = {
     /* VIC 1 */
     { {    25'175'000,   640,  480,  160,  45,   16,  96, 10,  2, 0, 0, 0, 0, { false, StereoMode::NO_STEREO, DigitalSeparateSync{ false, false } } },       N(1) },
     { {    27'000'000,   720,  480,  138,  45,   16,  62,  9,  6, 0, 0, 0, 0, { false, StereoMode::NO_STEREO, DigitalSeparateSync{ false, false } } },       N(1) },
@@ -153,7 +165,7 @@ namespace Edid {
     { { 1'485'000'000,  5120, 2160, 1480,  90, 1096,  88,  8, 10, 0, 0, 0, 0, { false, StereoMode::NO_STEREO, DigitalSeparateSync{  true,  true } } },       N(1) },
   };
 
-  static const std::vector<Cta861VideoTimingMode> cta_modes_2 = {
+  static constexpr Cta861VideoTimingMode cta_modes_2[] = {
     /* VIC 193 */
     { { 1'485'000'000,  5120, 2160,  380,  90,  164,  88,  8, 10, 0, 0, 0, 0, { false, StereoMode::NO_STEREO, DigitalSeparateSync{  true,  true } } },       N(1) },
     { { 1'188'000'000,  7680, 4320, 3320, 180, 2552, 176, 16, 20, 0, 0, 0, 0, { false, StereoMode::NO_STEREO, DigitalSeparateSync{  true,  true } } },       N(1) },
@@ -192,22 +204,43 @@ namespace Edid {
   #undef R
   #undef V
 
-  std::optional<Cta861VideoTimingMode> get_cta861_video_timing_mode(uint8_t vic) {
+  static_assert(ARRAY_SIZE(cta_modes_1) == 127, "CTA-861 table must cover VICs 1-127");
+  static_assert(ARRAY_SIZE(cta_modes_2) == 27, "CTA-861 table must cover VICs 193-219");
+
+  const Cta861VideoTimingMode* get_cta861_video_timing_mode(uint8_t vic) {
     if (vic >= 1 && vic <= 127) {
-      return cta_modes_1.at(vic - 1);
+      return &cta_modes_1[vic - 1];
     }
     else if (vic >= 129 && vic <= 192) {
-      return cta_modes_1.at(vic - 128 - 1);
+      return &cta_modes_1[vic - 128 - 1];
     }
     else if (vic >= 193 && vic <= 219) {
-      return cta_modes_2.at(vic - 193);
+      return &cta_modes_2[vic - 193];
     }
     else if (vic >= 220 && vic <= 255) {
-      return std::nullopt;
+      return nullptr;
     }
     throw EdidException(std::to_string(vic) + " is not a valid VIC");
   }
 
+  DetailedTimingDescriptor Cta861Timing::to_dtd() const {
+    return DetailedTimingDescriptor{
+      pixel_clock_hz, h_res, v_res, h_blanking, v_blanking, h_front_porch, h_sync_width,
+      v_front_porch, v_sync_width, h_image_size, v_image_size, h_border_pixels, v_border_lines,
+      DtdFeaturesBitmap{features_bitmap.interlaced, features_bitmap.stereo_mode, features_bitmap.sync}
+    };
+  }
+
+  VideoTimingMode to_video_timing_mode(const Cta861VideoTimingMode& mode) {
+    const Cta861Timing& dtd = mode.dtd;
+    return VideoTimingMode{
+      static_cast<uint16_t>(dtd.h_res / mode.min_pixel_repetition_factor()),
+      static_cast<uint16_t>(dtd.v_res * (dtd.features_bitmap.interlaced ? 2 : 1)),
+      std::make_pair(dtd.pixel_clock_hz, (dtd.v_res + dtd.v_blanking) * (dtd.h_res + dtd.h_blanking)),
+      dtd.features_bitmap.interlaced
+    };
+  }
+
   VideoTimingMode to_video_timing_mode(const DetailedTimingDescriptor& dtd, uint8_t pixel_repetition_factor) {
     return VideoTimingMode{
       static_cast<uint16_t>(dtd.h_res / pixel_repetition_factor),
@@ -216,4 +249,58 @@ namespace Edid {
       dtd.features_bitmap.interlaced
     };
   }
+
+  // Whether the value is within RATE_TOLERANCE_PPM of its nearest integer n
+  static bool snap_rate(double value, uint64_t& n) {
+    n = static_cast<uint64_t>(value + 0.5);
+    return n != 0 && std::abs(value - n) * 1'000'000 <= RATE_TOLERANCE_PPM * value;
+  }
+
+  Ratio canonical_rate(const Ratio& rate) {
+    if (rate.second == 0)
+      throw EdidException(__FUNCTION__, "Rate has zero denominator");
+
+    const uint64_t gcd = std::gcd(rate.first, rate.second);
+    const Ratio reduced{rate.first / gcd, rate.second / gcd};
+    if (reduced.second == 1)
+      return reduced;
+
+    const double value = static_cast<double>(reduced.first) / reduced.second;
+    uint64_t n;
+    if (snap_rate(value, n))
+      return {n, 1};
+    if (snap_rate(value * NTSC_FACTOR_DENOMINATOR / NTSC_FACTOR_NUMERATOR, n))
+      return {n * NTSC_FACTOR_NUMERATOR, NTSC_FACTOR_DENOMINATOR};
+    return reduced;
+  }
+
+  size_t VideoTimingModeHash::operator()(const VideoTimingMode& mode) const {
+    const uint64_t resolution =
+      static_cast<uint64_t>(mode.h_res) << 17 | static_cast<uint64_t>(mode.v_res) << 1 | mode.interlaced;
+    // Canonical rates have a denominator of 1 or 1001 in practice, so the numerator dominates
+    const uint64_t rate = mode.v_rate_hz.first * 1'000'003 ^ mode.v_rate_hz.second;
+    return std::hash<uint64_t>()(resolution * 0x9e3779b97f4a7c15 ^ rate);
+  }
+
+  ModeSet::ModeSet(const EdidData& edid) {
+    for_each_mode(edid, [this](const VideoTimingMode& mode) {
+      insert(mode);
+    });
+  }
+
+  bool ModeSet::insert(const VideoTimingMode& mode) {
+    if (mode.v_rate_hz.second == 0)
+      return false;
+    VideoTimingMode canonical = mode;
+    canonical.v_rate_hz = canonical_rate(mode.v_rate_hz);
+    return modes_.insert(canonical).second;
+  }
+
+  bool ModeSet::contains(const VideoTimingMode& mode) const {
+    if (mode.v_rate_hz.second == 0)
+      return false;
+    VideoTimingMode canonical = mode;
+    canonical.v_rate_hz = canonical_rate(mode.v_rate_hz);
+    return modes_.count(canonical) != 0;
+  }
 }  // namespace Edid
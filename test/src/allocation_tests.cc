@@ -0,0 +1,111 @@
+// Copyright 2023 N-Nagorny
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+#include <gtest/gtest.h>
+
+#include "edid/edid.hh"
+#include "edid/timing_modes.hh"
+
+#include "common.hh"
+
+using namespace Edid;
+
+namespace {
+  std::atomic<size_t> allocations{0};
+
+  // Counts heap allocations made by the calling code within its scope
+  class AllocationCounter {
+   public:
+    AllocationCounter() : start_(allocations.load()) {}
+    size_t count() const { return allocations.load() - start_; }
+
+   private:
+    size_t start_;
+  };
+
+  EdidData make_hdmi_edid() {
+    Cta861Block cta861 = make_cta861_ext();
+    SpeakerAllocationDataBlock speaker_allocation_data_block;
+    speaker_allocation_data_block.speaker_allocation |= FRONT_LEFT_AND_RIGHT;
+    cta861.data_block_collection.push_back(speaker_allocation_data_block);
+    cta861.data_block_collection.push_back(HdmiVendorDataBlock{
+      {1, 0, 0, 0}, HVDBB6F_DC_Y444, 340, 0, std::nullopt, std::nullopt,
+      HdmiVideoSubblock{ISM_NO_INFO, {1, 2, 3, 4}}
+    });
+    cta861.detailed_timing_descriptors.push_back(cta861.detailed_timing_descriptors.front());
+    return EdidData{make_edid_base(), std::vector{cta861}};
+  }
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+TEST(AllocationTests, HdmiEdidParsing) {
+  const EdidData edid = make_hdmi_edid();
+  const std::vector<uint8_t> edid_binary = generate_edid_binary(edid);
+
+  AllocationCounter counter;
+  const EdidData parsed = parse_edid_binary(edid_binary.data(), edid_binary.size());
+  // One per container: extension blocks, data block collection, VICs, SADs,
+  // HDMI VICs and DTDs
+  EXPECT_LE(counter.count(), 6);
+  EXPECT_EQ(edid, parsed);
+}
+
+TEST(AllocationTests, HdmiEdidParsingIntoArena) {
+  const EdidData edid = make_hdmi_edid();
+  const std::vector<uint8_t> edid_binary = generate_edid_binary(edid);
+
+  std::array<std::byte, 4096> buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+  AllocationCounter counter;
+  const EdidData parsed = parse_edid_binary(edid_binary.data(), edid_binary.size(), &arena);
+  // Only the vector of extension blocks is allocated outside the arena
+  EXPECT_LE(counter.count(), 1);
+  EXPECT_EQ(edid, parsed);
+  EXPECT_EQ(parsed.extension_blocks->at(0).data_block_collection.get_allocator().resource(), &arena);
+}
+
+TEST(AllocationTests, HdmiEdidGeneratingIntoBuffer) {
+  const EdidData edid = make_hdmi_edid();
+  const std::vector<uint8_t> expected = generate_edid_binary(edid);
+
+  std::array<uint8_t, 2 * EDID_BLOCK_SIZE> buffer;
+  AllocationCounter counter;
+  const size_t size = generate_edid_binary(edid, buffer.data(), buffer.size());
+  EXPECT_EQ(counter.count(), 0);
+  ASSERT_EQ(size, expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+  EXPECT_THROW(generate_edid_binary(edid, buffer.data(), EDID_BLOCK_SIZE), EdidException);
+}
+
+TEST(AllocationTests, BaseBlockModeEnumeration) {
+  BaseBlock base_block = make_edid_base();
+  base_block.established_timings_1 = BITMASK_TRUE(8);
+  base_block.established_timings_2 = BITMASK_TRUE(8);
+  base_block.manufacturers_timings = ET_1152x870_75;
+
+  AllocationCounter counter;
+  size_t modes = 0;
+  for_each_mode(base_block, [&modes](const VideoTimingMode&) { ++modes; });
+  remove_mode_if(base_block, [](const VideoTimingMode& mode) { return mode.v_res == 600; });
+  EXPECT_EQ(counter.count(), 0);
+  EXPECT_GT(modes, 17);
+  EXPECT_EQ(base_block.established_timings_1 & (ET_800x600_60 | ET_800x600_56), 0);
+}
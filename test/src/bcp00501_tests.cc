@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include "edid/bcp00501.hh"
+#include "edid/edid_cache.hh"
 
 #include "common.hh"
 
@@ -32,7 +33,8 @@ TEST(Bcp00501Tests, BasicTest) {
   nlohmann::json j_expected = {
     VIDEO_MODE(1920, 1080, ARR(RATE(50)), ARR("progressive")),
     VIDEO_MODE(720, 480, ARR(RATE59_94), ARR("progressive")),
-    VIDEO_MODE(640, 480, ARR({{ "denominator", 420000}, {"numerator", 25175000} }), ARR("progressive")),
+    // 25.175 MHz / 420000 pixels is within tolerance of 59.94 Hz
+    VIDEO_MODE(640, 480, ARR(RATE59_94), ARR("progressive")),
     VIDEO_MODE(1280, 720, ARR(RATE(50)), ARR("progressive")),
     VIDEO_MODE(1920, 1080, ARR(RATE(60)), ARR("progressive")),
     VIDEO_MODE(1152, 870, ARR(RATE(75)), ARR("progressive")),
@@ -59,3 +61,13 @@ TEST(Bcp00501Tests, BasicTest) {
 
   EXPECT_EQ(j_expected, j_actual);
 }
+
+TEST(Bcp00501Tests, CachedConstraintSets) {
+  EdidData edid{make_edid_base(), std::vector<Cta861Block>{make_cta861_ext()}};
+  const auto binary = generate_edid_binary(edid);
+
+  EdidCache cache;
+  const auto constraint_sets = cache.constraint_sets(binary);
+  EXPECT_EQ(*constraint_sets, generate_constraint_sets(edid));
+  EXPECT_EQ(cache.constraint_sets(binary), constraint_sets);
+}
@@ -5,6 +5,7 @@
 
 #include "edid/json.hh"
 #include "edid/json_schemas.hh"
+#include "edid/json_writer.hh"
 
 #include "common.hh"
 
@@ -729,3 +730,118 @@ TEST(JsonTests, HdrStaticMetadataDataBlockRoundtrip) {
   const HdrStaticMetadataDataBlock parsed = json;
   EXPECT_EQ(initial, parsed);
 }
+
+TEST(JsonSchemasTests, CompiledOnce) {
+  EXPECT_EQ(&json_schemas::get_validator("edid.json"), &json_schemas::get_validator("edid.json"));
+  EXPECT_EQ(
+    &json_schemas::get_schema(nlohmann::json_uri{"base_block.json"}),
+    &json_schemas::get_schema(nlohmann::json_uri{"base_block.json"})
+  );
+  EXPECT_THROW(json_schemas::get_validator("missing.json"), std::runtime_error);
+  EXPECT_FALSE(is_json_satisfies_schema("missing.json", nlohmann::json::object()));
+}
+
+TEST(JsonSchemasTests, ValidatedEdidJson) {
+  const EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+
+  const ValidatedEdidJson trusted(edid);
+  EXPECT_EQ(trusted.json(), nlohmann::json(edid));
+  EXPECT_EQ(trusted.edid(), edid);
+
+  const ValidatedEdidJson untrusted = ValidatedEdidJson::validate(trusted.json());
+  EXPECT_EQ(untrusted.edid(), edid);
+  EXPECT_EQ(parse_edid_json(trusted.json()), edid);
+
+  nlohmann::json malformed = trusted.json();
+  malformed["base_block"].erase("manufacturer_id");
+  EXPECT_THROW(parse_edid_json(malformed), EdidException);
+
+  nlohmann::json oversized = trusted.json();
+  oversized["base_block"]["chromaticity"] = std::vector<uint8_t>(11);
+  EXPECT_THROW(parse_edid_json(oversized), EdidException);
+  EXPECT_THROW(oversized.get<EdidData>(), EdidException);
+
+  nlohmann::json short_manufacturer_id = trusted.json();
+  short_manufacturer_id["base_block"]["manufacturer_id"] = "AB";
+  EXPECT_THROW(parse_edid_json(short_manufacturer_id), EdidException);
+}
+
+TEST(JsonWriterTests, MatchesDump) {
+  Cta861Block cta861 = make_cta861_ext();
+  cta861.data_block_collection.push_back(SpeakerAllocationDataBlock{});
+  cta861.data_block_collection.push_back(YCbCr420CapabilityMapDataBlock{});
+  cta861.data_block_collection.push_back(ColorimetryDataBlock{CS_BT2020_RGB, 0});
+  cta861.data_block_collection.push_back(HdrStaticMetadataDataBlock{0b101, 1, 100, std::nullopt, 20});
+  cta861.data_block_collection.push_back(VideoCapabilityDataBlock{true, false, OUB_BOTH, OUB_NO_DATA, OUB_UNDER});
+  cta861.data_block_collection.push_back(UnknownDataBlock{{0x01, 0x02}, CTA861_EXTENDED_TAG, 0x20});
+  cta861.data_block_collection.push_back(UnknownDataBlock{{}, 0x06});
+
+  // Reserved LPCM bit depth bits alone and together with a defined one
+  AudioDataBlock audio_data_block;
+  audio_data_block.sads.push_back(ShortAudioDescriptor{AudioFormatCode::LPCM, AudioChannels::AC_2, SF_48, 0b1000});
+  audio_data_block.sads.push_back(ShortAudioDescriptor{AudioFormatCode::LPCM, AudioChannels::AC_2, SF_48, 0b1000 | LPCM_BD_16});
+  cta861.data_block_collection.push_back(audio_data_block);
+
+  HdmiVideoSubblock hdmi_video{ISM_NO_INFO, {1, 2}};
+  hdmi_video.stereo_video_support = StereoVideoSupport{std::pair<uint8_t, uint8_t>{0, 0}, std::nullopt};
+  hdmi_video.vic_3d_support.push_back(Vic3dSupport{0, SVTF_SIDE_BY_SIDE_HALF, SVS_HORIZONTAL});
+  hdmi_video.vic_3d_support.push_back(Vic3dSupport{1, SVTF_TOP_AND_BOTTOM, std::nullopt});
+  cta861.data_block_collection.push_back(HdmiVendorDataBlock{
+    {1, 0, 0, 0}, 0, 340, 0b0011, std::pair<uint8_t, uint8_t>{10, 20}, std::nullopt, hdmi_video
+  });
+  hdmi_video.stereo_video_support = StereoVideoSupport{std::pair<uint8_t, uint8_t>{1, 0x40}, 0x8001};
+  cta861.data_block_collection.push_back(HdmiVendorDataBlock{
+    {2, 0, 0, 0}, HVDBB6F_DC_Y444 | HVDBB6F_DC_30BIT, std::nullopt, 0, std::nullopt, std::nullopt, hdmi_video
+  });
+
+  BaseBlock base_block = make_edid_base();
+  base_block.manufacture_date_or_model_year = ModelYear{2023};
+  base_block.eighteen_byte_descriptors[2] = AsciiString{"\"Q\\\t", ASCII_DISPLAY_NAME};
+
+  const std::vector<EdidData> edids = {
+    EdidData{make_edid_base()},
+    EdidData{make_edid_base(), std::vector{make_cta861_ext()}},
+    EdidData{base_block, std::vector{cta861, make_cta861_ext()}},
+  };
+
+  std::string buffer;
+  for (const auto& edid : edids) {
+    const nlohmann::json json = edid;
+    for (int indent : {-1, 0, 2}) {
+      buffer.clear();
+      write_edid_json(edid, buffer, indent);
+      EXPECT_EQ(buffer, json.dump(indent));
+    }
+
+    std::ostringstream os;
+    write_edid_json(edid, os);
+    EXPECT_EQ(os.str(), json.dump());
+  }
+}
+
+TEST(JsonTests, BinaryFormatsRoundtrip) {
+  const EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  const size_t json_size = nlohmann::json(edid).dump().size();
+
+  const auto cbor = generate_edid_cbor(edid);
+  EXPECT_LT(cbor.size(), json_size);
+  EXPECT_EQ(parse_edid_cbor(cbor), edid);
+
+  const auto msgpack = generate_edid_msgpack(edid);
+  EXPECT_LT(msgpack.size(), json_size);
+  EXPECT_EQ(parse_edid_msgpack(msgpack), edid);
+
+  EXPECT_THROW(parse_edid_cbor(cbor.data(), cbor.size() / 2), EdidException);
+  EXPECT_THROW(parse_edid_msgpack(msgpack.data(), msgpack.size() / 2), EdidException);
+  EXPECT_THROW(parse_edid_cbor(nlohmann::json::to_cbor(nlohmann::json::array())), EdidException);
+
+  nlohmann::json oversized = edid;
+  oversized["base_block"]["standard_timings"] = std::vector<nlohmann::json>(9, oversized["base_block"]["standard_timings"][0]);
+  EXPECT_THROW(parse_edid_cbor(nlohmann::json::to_cbor(oversized)), EdidException);
+  oversized = edid;
+  oversized["base_block"]["eighteen_byte_descriptors"] =
+    std::vector<nlohmann::json>(5, oversized["base_block"]["eighteen_byte_descriptors"][0]);
+  EXPECT_THROW(parse_edid_msgpack(nlohmann::json::to_msgpack(oversized)), EdidException);
+  oversized["base_block"]["manufacturer_id"] = "";
+  EXPECT_THROW(parse_edid_msgpack(nlohmann::json::to_msgpack(oversized)), EdidException);
+}
@@ -1,6 +1,7 @@
 // Copyright 2023 N-Nagorny
 
 #include "edid/edid.hh"
+#include "edid/file_io.hh"
 #include "edid/json.hh"
 #include "edid/json_schemas.hh"
 
@@ -19,11 +20,7 @@ using namespace Edid;
 static std::vector<std::string> edid_files = {};
 
 void validate_edid_json(const nlohmann::json& j) {
-  nlohmann::json_schema::json_validator validator{
-    Edid::json_schemas::schemas.at(nlohmann::json_uri{"edid.json"}),
-    Edid::json_schemas::schema_loader
-  };
-  validator.validate(j);
+  Edid::json_schemas::get_validator("edid.json").validate(j);
 }
 
 class EdidRoundtripTest : public testing::TestWithParam<std::string> {};
@@ -1,6 +1,7 @@
 // Copyright 2023 N-Nagorny
 
 #include "edid/edid.hh"
+#include "edid/file_io.hh"
 
 #include <fstream>
 #include <iostream>
@@ -17,9 +18,10 @@ class EdidRoundtripTest : public testing::TestWithParam<std::string> {};
 TEST_P(EdidRoundtripTest, EdidRoundtrip) {
   // EDID binary -> Edid::EdidData -> EDID binary
   const auto file_path = GetParam();
-  const std::vector<uint8_t> edid_binary = read_file(file_path);
+  const MappedFile file(file_path);
+  const std::vector<uint8_t> edid_binary(file.data(), file.data() + file.size());
 
-  const EdidData edid = Edid::parse_edid_binary(edid_binary);
+  const EdidData edid = Edid::parse_edid_binary(file.data(), file.size());
   const auto generated_edid_binary = Edid::generate_edid_binary(edid);
 
   EXPECT_EQ(edid_binary, generated_edid_binary);
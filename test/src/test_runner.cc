@@ -1,12 +1,23 @@
 // Copyright 2023 N-Nagorny
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <sstream>
+#include <thread>
 
 #include <gtest/gtest.h>
 
 #include "edid/base_block.hh"
 #include "edid/edid.hh"
+#include "edid/edid_cache.hh"
+#include "edid/edid_corpus.hh"
+#include "edid/edid_encoder.hh"
+#include "edid/edid_stream.hh"
+#include "edid/file_io.hh"
+#include "edid/filesystem.hh"
+#include "edid/json_reader.hh"
+#include "edid/json_writer.hh"
 
 #include "edid/timing_modes.hh"
 
@@ -210,6 +221,510 @@ TEST(CommonRoundtrips, FullEdid) {
   EXPECT_EQ(edid, parse_edid_binary(edid_binary));
 }
 
+TEST(CommonRoundtrips, FullEdidInPlace) {
+  EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  auto edid_binary = generate_edid_binary(edid);
+  // Parse a slice of a bigger buffer as if it was a memory-mapped file
+  std::vector<uint8_t> buffer(EDID_BLOCK_SIZE, 0xAB);
+  buffer.insert(buffer.end(), edid_binary.begin(), edid_binary.end());
+  EXPECT_EQ(edid, parse_edid_binary(buffer.data() + EDID_BLOCK_SIZE, edid_binary.size()));
+}
+
+TEST(CommonRoundtrips, TruncatedEdidIsRejected) {
+  EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  auto edid_binary = generate_edid_binary(edid);
+  EXPECT_THROW(parse_edid_binary(edid_binary.data(), EDID_BLOCK_SIZE), EdidException);
+}
+
+TEST(ChecksumTests, BlockChecksum) {
+  std::array<uint8_t, EDID_BLOCK_SIZE> block;
+  for (int i = 0; i < EDID_BLOCK_SIZE; ++i)
+    block[i] = static_cast<uint8_t>(i * 37 + 11);
+  int sum = 0;
+  for (int i = 0; i < EDID_BLOCK_SIZE - 1; ++i)
+    sum += block[i];
+  EXPECT_EQ(calculate_block_checksum(block), static_cast<uint8_t>(256 - sum % 256));
+
+  block.fill(0);
+  EXPECT_EQ(calculate_block_checksum(block), 0);
+}
+
+TEST(ChecksumTests, VerifyAndRepairBlocks) {
+  auto edids = generate_edid_binary(EdidData{make_edid_base(), std::vector{make_cta861_ext()}});
+  const auto valid = edids;
+  edids.insert(edids.end(), valid.begin(), valid.end());
+  const size_t count = edids.size() / EDID_BLOCK_SIZE;
+  EXPECT_EQ(verify_checksums(edids.data(), count), count);
+
+  edids[2 * EDID_BLOCK_SIZE + 20] ^= 0x5A;
+  edids[3 * EDID_BLOCK_SIZE + 5] += 1;
+  EXPECT_EQ(verify_checksums(edids.data(), count), 2);
+  EXPECT_EQ(repair_checksums(edids.data(), count), 2);
+  EXPECT_EQ(verify_checksums(edids.data(), count), count);
+  EXPECT_EQ(edids[3 * EDID_BLOCK_SIZE + EDID_BLOCK_SIZE - 1], static_cast<uint8_t>(valid[2 * EDID_BLOCK_SIZE - 1] - 1));
+}
+
+TEST(TryParseTests, ValidEdid) {
+  EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  auto result = try_parse_edid_binary(generate_edid_binary(edid));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(edid, *result);
+}
+
+TEST(TryParseTests, MaximumExtensionBlocks) {
+  const EdidData edid{make_edid_base(), std::vector<Cta861Block>(255, make_cta861_ext())};
+  const auto edid_binary = generate_edid_binary(edid);
+  EXPECT_EQ(check_edid_binary(edid_binary.data(), edid_binary.size()), std::nullopt);
+
+  auto result = try_parse_edid_binary(edid_binary);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(edid, *result);
+}
+
+TEST(TryParseTests, InvalidEdids) {
+  EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  const auto edid_binary = generate_edid_binary(edid);
+
+  auto result = try_parse_edid_binary(edid_binary.data(), 200);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_INVALID_SIZE, 0, 0, 200}));
+
+  result = try_parse_edid_binary(edid_binary.data(), EDID_BLOCK_SIZE);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_TRUNCATED, 0, 126, 1}));
+
+  auto corrupted = edid_binary;
+  corrupted[EDID_BLOCK_SIZE + 10] ^= 0xFF;
+  result = try_parse_edid_binary(corrupted);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error().code, PE_INVALID_CHECKSUM);
+  EXPECT_EQ(result.error().block_index, 1);
+  EXPECT_EQ(result.error().byte_offset, 2 * EDID_BLOCK_SIZE - 1);
+  EXPECT_THROW(parse_edid_binary(corrupted), EdidException);
+  EXPECT_THROW(result.value(), EdidException);
+
+  corrupted = edid_binary;
+  corrupted[EDID_BLOCK_SIZE] = 0x70;  // DisplayID
+  result = try_parse_edid_binary(corrupted);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_INVALID_EXTENSION_TAG, 1, EDID_BLOCK_SIZE, 0x70}));
+  EXPECT_EQ(result.error().message(), "Block 1, byte 128: CTA Extension has invalid Extension Tag: 112");
+}
+
+TEST(TryParseTests, InvalidDataBlockLength) {
+  Cta861Block cta861 = make_cta861_ext();
+  cta861.data_block_collection.push_back(UnknownDataBlock{{1, 2, 3, 4}, CTA861_SPEAKERS_DATA_BLOCK_TAG});
+  const auto edid_binary = generate_edid_binary(EdidData{make_edid_base(), std::vector{cta861}});
+
+  auto result = try_parse_edid_binary(edid_binary);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error().code, PE_INVALID_DATA_BLOCK_LENGTH);
+  EXPECT_EQ(result.error().value, 4);
+  EXPECT_THROW(parse_edid_binary(edid_binary), EdidException);
+}
+
+TEST(TryParseTests, InvalidExtendedTagDataBlockLength) {
+  Cta861Block cta861 = make_cta861_ext();
+  cta861.data_block_collection.push_back(ColorimetryDataBlock{CS_BT2020_RGB, 0});
+  cta861.data_block_collection.push_back(VideoCapabilityDataBlock{false, false, OUB_NO_DATA, OUB_NO_DATA, OUB_NO_DATA});
+  const auto edid_binary = generate_edid_binary(EdidData{make_edid_base(), std::vector{cta861}});
+  // Video Capability Data Block is the last one before the DTDs, Colorimetry Data Block precedes it
+  const size_t video_capability_pos = EDID_BLOCK_SIZE + edid_binary[EDID_BLOCK_SIZE + 2] - 3;
+  const size_t colorimetry_pos = video_capability_pos - 4;
+  ASSERT_EQ(edid_binary[video_capability_pos], 0xE2);
+  ASSERT_EQ(edid_binary[colorimetry_pos], 0xE3);
+
+  // Extended Tag Data Block without Extended Tag, the bytes after it read as empty reserved blocks
+  auto corrupted = edid_binary;
+  corrupted[video_capability_pos] = 0xE0;
+  repair_checksums(corrupted.data(), 2);
+  auto result = try_parse_edid_binary(corrupted);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_INVALID_DATA_BLOCK_LENGTH, 1, video_capability_pos, 0}));
+  EXPECT_THROW(parse_edid_binary(corrupted), EdidException);
+
+  // Colorimetry Data Block one byte short, its last byte reads as an empty reserved block
+  corrupted = edid_binary;
+  corrupted[colorimetry_pos] = 0xE2;
+  corrupted[colorimetry_pos + 3] = 0;
+  repair_checksums(corrupted.data(), 2);
+  result = try_parse_edid_binary(corrupted);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_INVALID_DATA_BLOCK_LENGTH, 1, colorimetry_pos, 2}));
+  EXPECT_THROW(parse_edid_binary(corrupted), EdidException);
+}
+
+TEST(TryParseTests, BlocksRunningPastTheirBounds) {
+  auto edid_binary = generate_edid_binary(EdidData{make_edid_base(), std::vector{make_cta861_ext()}});
+  const uint8_t dtd_start_pos = edid_binary[EDID_BLOCK_SIZE + 2];
+
+  // Video Data Block claims one more VIC, so it runs into the DTDs
+  auto overrun = edid_binary;
+  overrun[EDID_BLOCK_SIZE + 4] += 1;
+  repair_checksums(overrun.data(), 2);
+  auto result = try_parse_edid_binary(overrun);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_DATA_BLOCK_OVERRUN, 1, EDID_BLOCK_SIZE + 2, dtd_start_pos}));
+  EXPECT_THROW(parse_edid_binary(overrun), EdidException);
+
+  // The last Data Block before byte 126 claims 31 bytes, which would run past the block
+  uint8_t* cta861 = edid_binary.data() + EDID_BLOCK_SIZE;
+  std::fill(cta861 + 4, cta861 + EDID_BLOCK_SIZE, 0);
+  cta861[2] = EDID_BLOCK_SIZE - 2;
+  for (int pos : {4, 36, 68})
+    cta861[pos] = 31;
+  cta861[100] = 24;
+  cta861[125] = 31;
+  repair_checksums(edid_binary.data(), 2);
+  result = try_parse_edid_binary(edid_binary);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_DATA_BLOCK_OVERRUN, 1, EDID_BLOCK_SIZE + 2, EDID_BLOCK_SIZE - 2}));
+  EXPECT_THROW(parse_edid_binary(edid_binary), EdidException);
+
+  // A DTD starting at byte 120 would run past the checksum
+  std::fill(cta861 + 4, cta861 + EDID_BLOCK_SIZE, 0);
+  cta861[2] = 120;
+  for (int pos : {4, 36, 68})
+    cta861[pos] = 31;
+  cta861[100] = 19;
+  cta861[120] = 0x01;
+  cta861[121] = 0x01;
+  repair_checksums(edid_binary.data(), 2);
+  result = try_parse_edid_binary(edid_binary);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), (ParseError{PE_INVALID_DTD_OFFSET, 1, EDID_BLOCK_SIZE + 2, 120}));
+  EXPECT_THROW(parse_edid_binary(edid_binary), EdidException);
+}
+
+TEST(CheckEdidBinaryTests, DataBlockOverrun) {
+  auto edid_binary = generate_edid_binary(EdidData{make_edid_base(), std::vector{make_cta861_ext()}});
+  EXPECT_EQ(check_edid_binary(edid_binary.data(), edid_binary.size()), std::nullopt);
+
+  // Video Data Block claims one more VIC, so the collection runs into the DTDs
+  edid_binary[EDID_BLOCK_SIZE + 4] += 1;
+  repair_checksums(edid_binary.data(), 2);
+  EXPECT_EQ(check_edid_binary(edid_binary.data(), edid_binary.size()),
+    (ParseError{PE_DATA_BLOCK_OVERRUN, 1, EDID_BLOCK_SIZE + 2, edid_binary[EDID_BLOCK_SIZE + 2]}));
+
+  edid_binary[5] ^= 0xFF;
+  EXPECT_EQ(check_edid_binary(edid_binary.data(), edid_binary.size())->code, PE_INVALID_HEADER);
+}
+
+TEST(EdidViewTests, MatchesParsedEdid) {
+  Cta861Block cta861 = make_cta861_ext();
+  cta861.data_block_collection.push_back(HdmiVendorDataBlock{{1, 0, 0, 0}, 0, 340});
+  EdidData edid{make_edid_base(), std::vector{cta861}};
+  edid.base_block.serial_number = 0xDEADBEEF;
+  auto edid_binary = generate_edid_binary(edid);
+
+  EdidView view(edid_binary);
+  EXPECT_EQ(view.manufacturer_id(), edid.base_block.manufacturer_id);
+  EXPECT_EQ(view.product_code(), edid.base_block.product_code);
+  EXPECT_EQ(view.serial_number(), edid.base_block.serial_number);
+  EXPECT_EQ(view.extension_blocks(), 1);
+  EXPECT_EQ(view.preferred_dtd(), std::get<DetailedTimingDescriptor>(edid.base_block.eighteen_byte_descriptors[0]));
+  const auto& vics = std::get<VideoDataBlock>(cta861.data_block_collection[0]).vics;
+  EXPECT_EQ(view.vics(), std::vector<uint8_t>(vics.begin(), vics.end()));
+  EXPECT_EQ(view.hdmi_max_tmds_clock_mhz(), 340);
+}
+
+TEST(EdidViewTests, BaseBlockOnly) {
+  BaseBlock base_block = make_edid_base();
+  base_block.eighteen_byte_descriptors[0] = DummyDescriptor{};
+  auto edid_binary = generate_edid_binary(EdidData{base_block});
+
+  EdidView view(edid_binary);
+  EXPECT_EQ(view.extension_blocks(), 0);
+  EXPECT_EQ(view.block(1), nullptr);
+  EXPECT_EQ(view.preferred_dtd(), std::nullopt);
+  EXPECT_TRUE(view.vics().empty());
+  EXPECT_EQ(view.hdmi_max_tmds_clock_mhz(), std::nullopt);
+  EXPECT_THROW(EdidView(edid_binary.data(), 100), EdidException);
+}
+
+TEST(EdidViewTests, MaximumExtensionBlocks) {
+  const Cta861Block cta861 = make_cta861_ext();
+  const auto edid_binary = generate_edid_binary(EdidData{make_edid_base(), std::vector<Cta861Block>(255, cta861)});
+
+  EdidView view(edid_binary);
+  EXPECT_EQ(view.extension_blocks(), 255);
+  EXPECT_EQ(view.vics().size(), 255 * std::get<VideoDataBlock>(cta861.data_block_collection[0]).vics.size());
+}
+
+TEST(ParseBatchTests, MatchesSequentialParsing) {
+  const auto valid = generate_edid_binary(EdidData{make_edid_base(), std::vector{make_cta861_ext()}});
+  auto corrupted = valid;
+  corrupted[EDID_BLOCK_SIZE + 10] ^= 0xFF;
+
+  std::vector<std::vector<uint8_t>> batch;
+  for (int i = 0; i < 100; ++i)
+    batch.push_back(i % 7 == 0 ? corrupted : valid);
+  batch.insert(batch.begin() + 50, std::vector<uint8_t>{});
+
+  const auto results = parse_edid_batch(batch, 4);
+  ASSERT_EQ(results.size(), batch.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const auto expected = try_parse_edid_binary(batch[i]);
+    ASSERT_EQ(results[i].has_value(), expected.has_value());
+    if (expected)
+      EXPECT_EQ(*results[i], *expected);
+    else
+      EXPECT_EQ(results[i].error(), expected.error());
+  }
+  EXPECT_EQ(parse_edid_batch(batch, 0).size(), batch.size());
+  EXPECT_EQ(parse_edid_batch(batch, 1000).size(), batch.size());
+  EXPECT_TRUE(parse_edid_batch(std::vector<std::vector<uint8_t>>{}).empty());
+}
+
+TEST(EdidCacheTests, SharesParsedEdids) {
+  const EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  const auto binary = generate_edid_binary(edid);
+
+  EdidCache cache;
+  const auto parsed = cache.edid(binary);
+  EXPECT_EQ(*parsed, edid);
+  EXPECT_EQ(cache.edid(binary), parsed);
+  EXPECT_EQ(*cache.modes(binary), ModeSet(edid));
+  EXPECT_EQ(cache.modes(binary), cache.modes(binary.data(), binary.size()));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.hits(), 4);
+
+  auto invalid_binary = binary;
+  invalid_binary[0] = 0x42;
+  EXPECT_THROW(cache.edid(invalid_binary), EdidException);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_THROW(cache.edid(nullptr, 0), EdidException);
+  EXPECT_EQ(hash_edid_binary(nullptr, 0), hash_edid_binary(binary.data(), 0));
+}
+
+TEST(EdidCacheTests, EvictsLeastRecentlyUsed) {
+  const EdidData edid{make_edid_base()};
+  std::vector<std::vector<uint8_t>> binaries;
+  for (uint32_t serial_number = 0; serial_number < 16; ++serial_number) {
+    EdidData temp = edid;
+    temp.base_block.serial_number = serial_number;
+    binaries.push_back(generate_edid_binary(temp));
+  }
+
+  EdidCache cache(2 * (EDID_BLOCK_SIZE + EDID_CACHE_ENTRY_OVERHEAD));
+  const auto first = cache.edid(binaries[0]);
+  cache.edid(binaries[1]);
+  cache.edid(binaries[0]);
+  cache.edid(binaries[2]);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.memory_usage(), 2 * (EDID_BLOCK_SIZE + EDID_CACHE_ENTRY_OVERHEAD));
+
+  // Evicted results stay valid
+  EXPECT_EQ(first->base_block.serial_number, 0);
+  EXPECT_EQ(cache.edid(binaries[0]), first);
+  cache.edid(binaries[1]);
+  EXPECT_EQ(cache.misses(), 4);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.memory_usage(), 0);
+}
+
+TEST(EdidCacheTests, ConcurrentReaders) {
+  const EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  const auto binary = generate_edid_binary(edid);
+  EdidCache cache;
+
+  std::vector<std::thread> threads;
+  std::atomic<size_t> mismatches{0};
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 100; ++j) {
+        if (!(*cache.edid(binary) == edid) || cache.modes(binary)->empty())
+          ++mismatches;
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(mismatches, 0);
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(EdidCorpusTests, WritesAndMapsRecords) {
+  const std::string path = (std::filesystem::temp_directory_path() / "edid_corpus_test.bin").string();
+
+  std::vector<std::vector<uint8_t>> binaries;
+  for (uint32_t serial_number = 0; serial_number < 16; ++serial_number) {
+    EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+    edid.base_block.serial_number = serial_number;
+    edid.base_block.product_code = 1000 + serial_number;
+    binaries.push_back(generate_edid_binary(edid));
+  }
+  binaries.push_back(generate_edid_binary(EdidData{make_edid_base()}));
+  // A duplicate is found as its first record
+  binaries.push_back(binaries[1]);
+
+  {
+    EdidCorpusWriter writer(path);
+    for (const auto& binary : binaries)
+      writer.add(binary);
+    EXPECT_THROW(writer.add(std::vector<uint8_t>(EDID_BLOCK_SIZE)), EdidException);
+    EXPECT_EQ(writer.size(), binaries.size());
+  }
+
+  {
+    const EdidCorpus corpus(path);
+    ASSERT_EQ(corpus.size(), binaries.size());
+    for (size_t i = 0; i < binaries.size(); ++i) {
+      const EdidCorpusEntry entry = corpus.entry(i);
+      EXPECT_EQ(entry.size, binaries[i].size());
+      EXPECT_EQ(entry.hash, hash_edid_binary(binaries[i].data(), binaries[i].size()));
+      EXPECT_EQ(entry.manufacturer_id, (std::array<char, 3>{'A', 'B', 'C'}));
+
+      const EdidView view = corpus.view(i);
+      EXPECT_EQ(std::vector<uint8_t>(view.data(), view.data() + view.size()), binaries[i]);
+      EXPECT_EQ(view.product_code(), entry.product_code);
+      EXPECT_EQ(corpus.find(binaries[i]), i + 1 == binaries.size() ? 1 : i);
+    }
+    EXPECT_EQ(corpus.entry(1).product_code, 1001);
+    EXPECT_THROW(corpus.entry(binaries.size()), EdidException);
+
+    auto unknown = binaries[0];
+    unknown[12] = 0xFF;
+    EXPECT_EQ(corpus.find(unknown), std::nullopt);
+  }
+
+  // Lookup table pointing past the records
+  {
+    std::fstream file(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    file.seekp(-EDID_CORPUS_LOOKUP_ENTRY_SIZE, std::ios_base::end);
+    const char invalid_record[EDID_CORPUS_LOOKUP_ENTRY_SIZE] = {'\xFF', '\xFF', '\xFF', '\xFF'};
+    file.write(invalid_record, sizeof(invalid_record));
+  }
+  EXPECT_THROW(EdidCorpus corpus(path), EdidException);
+
+  // Truncated index
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  EXPECT_THROW(EdidCorpus corpus(path), EdidException);
+  std::filesystem::remove(path);
+  EXPECT_THROW(EdidCorpus corpus(path), EdidException);
+}
+
+TEST(FileIoTests, MapsAndLoadsDirectories) {
+  const auto directory = std::filesystem::temp_directory_path() / "edid_file_io_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory / "nested");
+
+  const auto write = [](const std::filesystem::path& path, const std::vector<uint8_t>& contents) {
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary);
+    file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+  };
+  const std::vector<uint8_t> edid_binary = generate_edid_binary(EdidData{make_edid_base(), std::vector{make_cta861_ext()}});
+  const std::vector<uint8_t> base_block = generate_edid_binary(EdidData{make_edid_base()});
+  write(directory / "b.bin", edid_binary);
+  write(directory / "a.bin", base_block);
+  write(directory / "empty.bin", {});
+  write(directory / "nested" / "c.bin", edid_binary);
+
+  {
+    MappedFile file((directory / "b.bin").string());
+    ASSERT_EQ(file.size(), edid_binary.size());
+    EXPECT_EQ(std::vector<uint8_t>(file.data(), file.data() + file.size()), edid_binary);
+    EXPECT_EQ(parse_edid_binary(file.data(), file.size()), parse_edid_binary(edid_binary));
+
+    const MappedFile moved = std::move(file);
+    EXPECT_EQ(moved.size(), edid_binary.size());
+    EXPECT_EQ(file.data(), nullptr);
+
+    const MappedFile empty((directory / "empty.bin").string());
+    EXPECT_EQ(empty.size(), 0);
+  }
+  EXPECT_EQ(read_file((directory / "a.bin").string()), base_block);
+  EXPECT_THROW(MappedFile file(directory.string()), std::runtime_error);
+  EXPECT_THROW(read_file((directory / "missing.bin").string()), std::runtime_error);
+
+  const std::vector<LoadedFile> files = load_directory(directory.string());
+  ASSERT_EQ(files.size(), 3);
+  EXPECT_EQ(files[0].path, (directory / "a.bin").string());
+  EXPECT_EQ(files[0].contents, base_block);
+  EXPECT_EQ(files[1].contents, edid_binary);
+  EXPECT_TRUE(files[2].contents.empty());
+
+  const std::vector<LoadedFile> all_files = load_directory(directory.string(), true);
+  ASSERT_EQ(all_files.size(), 4);
+  EXPECT_EQ(all_files[3].path, (directory / "nested" / "c.bin").string());
+  EXPECT_EQ(all_files[3].contents, edid_binary);
+
+  std::filesystem::remove_all(directory);
+  EXPECT_THROW(load_directory(directory.string()), std::runtime_error);
+}
+
+TEST(EdidEncoderTests, ReencodesModifiedBlocks) {
+  EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  EdidEncoder encoder(edid);
+  EXPECT_EQ(encoder.binary(), generate_edid_binary(edid));
+
+  encoder.set_serial_number(0xDEADBEEF);
+  encoder.set_product_code(4321);
+  edid.base_block.serial_number = 0xDEADBEEF;
+  edid.base_block.product_code = 4321;
+  EXPECT_EQ(encoder.binary(), generate_edid_binary(edid));
+
+  encoder.modify_extension_block(0, [](Cta861Block& cta861) {
+    std::get<VideoDataBlock>(cta861.data_block_collection[0]).vics.push_back(97);
+  });
+  std::get<VideoDataBlock>(edid.extension_blocks->at(0).data_block_collection[0]).vics.push_back(97);
+  encoder.modify_base_block([](BaseBlock& base_block) { base_block.gamma = 120; });
+  edid.base_block.gamma = 120;
+  EXPECT_EQ(encoder.binary(), generate_edid_binary(edid));
+  EXPECT_EQ(encoder.edid(), edid);
+
+  encoder.set_extension_blocks(std::nullopt);
+  edid.extension_blocks = std::nullopt;
+  EXPECT_EQ(encoder.binary(), generate_edid_binary(edid));
+  EXPECT_THROW(encoder.modify_extension_block(0, [](Cta861Block&) {}), EdidException);
+}
+
+TEST(EdidStreamReaderTests, ConcatenatedEdids) {
+  EdidData edid_1{make_edid_base(), std::vector{make_cta861_ext()}};
+  EdidData edid_2{make_edid_base()};
+  edid_2.base_block.serial_number = 42;
+  const auto binary_1 = generate_edid_binary(edid_1);
+  const auto binary_2 = generate_edid_binary(edid_2);
+
+  std::string archive(binary_1.begin(), binary_1.end());
+  archive.append(binary_2.begin(), binary_2.end());
+  std::istringstream is(archive);
+
+  EdidStreamReader reader(is);
+  EXPECT_EQ(reader.next(), edid_1);
+  EXPECT_EQ(reader.offset(), 0);
+  EXPECT_EQ(reader.next(), edid_2);
+  EXPECT_EQ(reader.offset(), binary_1.size());
+  EXPECT_EQ(reader.next(), std::nullopt);
+  EXPECT_EQ(reader.skipped_bytes(), 0);
+}
+
+TEST(EdidStreamReaderTests, ResynchronisesAfterCorruptRecords) {
+  EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  const auto binary = generate_edid_binary(edid);
+  auto corrupted = binary;
+  corrupted[EDID_BLOCK_SIZE + 10] ^= 0xFF;
+
+  std::string archive = "garbage";
+  archive.append(corrupted.begin(), corrupted.end());
+  archive.append(binary.begin(), binary.end());
+  archive.append(binary.begin(), binary.begin() + EDID_BLOCK_SIZE);  // Truncated
+  std::istringstream is(archive);
+
+  EdidStreamReader reader(is);
+  auto view = reader.next_view();
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(reader.offset(), 7 + corrupted.size());
+  EXPECT_EQ(view->serial_number(), edid.base_block.serial_number);
+  EXPECT_EQ(parse_edid_binary(view->data(), view->size()), edid);
+  EXPECT_EQ(reader.next_view(), std::nullopt);
+  EXPECT_EQ(reader.skipped_bytes(), 7 + corrupted.size() + EDID_BLOCK_SIZE);
+}
+
 TEST(DataBlockCollection, DataBlockCollectionGenerating) {
   std::vector<uint8_t> dbc = {
     0x47, 0x10, 0x04, 0x1F, 0x13, 0x02, 0x12, 0x01, 0x23, 0x09, 0x07, 0x01, 0x67, 0xd8, 0x5d, 0xc4,
@@ -310,6 +825,42 @@ TEST(Cta861Block, Cta861BlockGenerating) {
   EXPECT_EQ(cta861_binary, generate_cta861_block(make_cta861_ext()));
 }
 
+TEST(Cta861VideoTimingModeTests, ConstantTableLookup) {
+  static_assert(std::is_trivially_copyable_v<Cta861VideoTimingMode>);
+
+  const Cta861VideoTimingMode* vic_16 = get_cta861_video_timing_mode(16);
+  ASSERT_NE(vic_16, nullptr);
+  EXPECT_EQ(get_cta861_video_timing_mode(144), vic_16);
+  EXPECT_EQ(vic_16->dtd.to_dtd(), (DetailedTimingDescriptor{
+    148'500'000, 1920, 1080, 280, 45, 88, 44,
+    4, 5, 0, 0, 0, 0, DtdFeaturesBitmap{false, NO_STEREO, DigitalSeparateSync{true, true}}
+  }));
+  EXPECT_EQ(to_video_timing_mode(*vic_16), to_video_timing_mode(vic_16->dtd.to_dtd()));
+
+  // 2880x480p60 allows pixel repetition factors of 1, 2 and 4
+  const Cta861VideoTimingMode* vic_35 = get_cta861_video_timing_mode(35);
+  EXPECT_EQ(vic_35->pixel_repetition_factors, 0b1011);
+  EXPECT_EQ(vic_35->min_pixel_repetition_factor(), 1);
+  // 2880x480i60 allows pixel repetition factors of 1 to 10
+  EXPECT_EQ(get_cta861_video_timing_mode(10)->pixel_repetition_factors, 0b1111111111);
+  EXPECT_EQ(get_cta861_video_timing_mode(6)->min_pixel_repetition_factor(), 2);
+
+  EXPECT_EQ(get_cta861_video_timing_mode(220), nullptr);
+  EXPECT_THROW(get_cta861_video_timing_mode(0), EdidException);
+}
+
+TEST(TimingModeTablesTests, ConstantTableLookup) {
+  EXPECT_EQ(et_1_to_video_mode(ET_800x600_60), (VideoTimingMode{800, 600, {60, 1}, false}));
+  EXPECT_EQ(mt_to_video_mode(ET_1152x870_75)->v_res, 870);
+  EXPECT_EQ(mt_to_video_mode(ManufacturersTiming(1 << 0)), nullptr);
+  EXPECT_EQ(et_3_to_video_mode(5, 1 << 0), nullptr);
+
+  const VideoTimingMode* mode = std_2_byte_code_to_video_mode({0xd1, 0xc0});
+  ASSERT_NE(mode, nullptr);
+  EXPECT_EQ(*mode, (VideoTimingMode{1920, 1080, {60, 1}, false}));
+  EXPECT_EQ(std_2_byte_code_to_video_mode({0xd1, 0xc5}), nullptr);
+}
+
 TEST(ForEachModeTests, DeleteModesFromBaseEdid) {
   BaseBlock edid_base_before = make_edid_base();
   BaseBlock edid_base_after = edid_base_before;
@@ -424,6 +975,108 @@ TEST(ForEachModeTests, DeleteModesFromOverallEdid) {
   EXPECT_EQ(edid_before, edid_after);
 }
 
+TEST(ModeSetTests, CanonicalRates) {
+  EXPECT_EQ(canonical_rate({148'500'000, 2'475'000}), (Ratio{60, 1}));
+  // 148.35 MHz DTD pixel clock of 1080p59.94
+  EXPECT_EQ(canonical_rate({148'350'000, 2'475'000}), (Ratio{60'000, 1'001}));
+  EXPECT_EQ(canonical_rate({24'000, 1'001}), (Ratio{24'000, 1'001}));
+  // 1024x768@75 of DMT is 75.03 Hz
+  EXPECT_EQ(canonical_rate({78'750'000, 1'049'600}), (Ratio{196'875, 2'624}));
+  EXPECT_THROW(canonical_rate({60, 0}), EdidException);
+}
+
+TEST(ModeSetTests, DeduplicatesModesOfOverallEdid) {
+  const EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+
+  size_t modes = 0;
+  for_each_mode(edid, [&modes](const VideoTimingMode&) { ++modes; });
+
+  ModeSet mode_set(edid);
+  EXPECT_LT(mode_set.size(), modes);
+  EXPECT_TRUE(mode_set.contains({1920, 1080, {60, 1}, false}));
+  EXPECT_FALSE(mode_set.insert({1920, 1080, {148'500'000, 2'475'000}, false}));
+  EXPECT_TRUE(mode_set.insert({1920, 1080, {148'350'000, 2'475'000}, false}));
+
+  EXPECT_EQ(ModeSet(edid), ModeSet(edid));
+  EXPECT_NE(ModeSet(edid), mode_set);
+  EXPECT_TRUE(ModeSet().empty());
+}
+
+TEST(ModeSetTests, SkipsModesWithoutRate) {
+  const EdidData edid{make_edid_base(), std::vector{make_cta861_ext()}};
+  EdidData zero_totals = edid;
+  DetailedTimingDescriptor dtd = zero_totals.extension_blocks->at(0).detailed_timing_descriptors.at(0);
+  dtd.h_res = 0;
+  dtd.h_blanking = 0;
+  zero_totals.extension_blocks->at(0).detailed_timing_descriptors.push_back(dtd);
+
+  EXPECT_EQ(ModeSet(zero_totals), ModeSet(edid));
+  ModeSet mode_set;
+  EXPECT_FALSE(mode_set.insert({1920, 1080, {148'500'000, 0}, false}));
+  EXPECT_FALSE(mode_set.contains({1920, 1080, {148'500'000, 0}, false}));
+  EXPECT_TRUE(mode_set.empty());
+}
+
+TEST(JsonReaderTests, WriterRoundtrip) {
+  Cta861Block cta861 = make_cta861_ext();
+  cta861.data_block_collection.push_back(SpeakerAllocationDataBlock{});
+  std::get<SpeakerAllocationDataBlock>(cta861.data_block_collection.back()).speaker_allocation = REAR_CENTER;
+  cta861.data_block_collection.push_back(ColorimetryDataBlock{CS_BT2020_RGB, 0});
+  cta861.data_block_collection.push_back(HdrStaticMetadataDataBlock{0b101, 1, 100, std::nullopt, 20});
+  cta861.data_block_collection.push_back(VideoCapabilityDataBlock{true, false, OUB_BOTH, OUB_NO_DATA, OUB_UNDER});
+  cta861.data_block_collection.push_back(UnknownDataBlock{{0x01, 0x02}, CTA861_EXTENDED_TAG, 0x20});
+
+  HdmiVideoSubblock hdmi_video{ISM_NO_INFO, {1, 2}};
+  hdmi_video.stereo_video_support = StereoVideoSupport{std::pair<uint8_t, uint8_t>{1, 0x40}, 0x8001};
+  hdmi_video.vic_3d_support.push_back(Vic3dSupport{0, SVTF_SIDE_BY_SIDE_HALF, SVS_HORIZONTAL});
+  hdmi_video.vic_3d_support.push_back(Vic3dSupport{1, SVTF_TOP_AND_BOTTOM, std::nullopt});
+  cta861.data_block_collection.push_back(HdmiVendorDataBlock{
+    {1, 0, 0, 0}, HVDBB6F_DC_Y444, 340, 0b0011,
+    std::pair<uint8_t, uint8_t>{10, 20}, std::pair<uint8_t, uint8_t>{30, 40}, hdmi_video
+  });
+
+  BaseBlock base_block = make_edid_base();
+  base_block.manufacture_date_or_model_year = ModelYear{2023};
+  base_block.eighteen_byte_descriptors[2] = AsciiString{"\"Q\\\t\x01", ASCII_DISPLAY_NAME};
+  base_block.eighteen_byte_descriptors[3] = DisplayRangeLimits{};
+
+  const std::vector<EdidData> edids = {
+    EdidData{make_edid_base()},
+    EdidData{make_edid_base(), std::vector<Cta861Block>{}},
+    EdidData{base_block, std::vector{cta861, make_cta861_ext()}},
+  };
+
+  std::string json;
+  for (const auto& edid : edids) {
+    for (int indent : {-1, 2}) {
+      json.clear();
+      write_edid_json(edid, json, indent);
+      EXPECT_EQ(read_edid_json(json), edid);
+    }
+  }
+
+  // Unknown members are skipped wherever they are
+  json.clear();
+  write_edid_json(edids.back(), json);
+  json.insert(1, "\"comment\": [1.5e3, -2, {\"a\": null}, \"\\u00e9\\ud83d\\ude00\", true], ");
+  EXPECT_EQ(read_edid_json(json), edids.back());
+}
+
+TEST(JsonReaderTests, MalformedInput) {
+  std::string json;
+  write_edid_json(EdidData{make_edid_base(), std::vector{make_cta861_ext()}}, json);
+
+  EXPECT_THROW(read_edid_json(json.substr(0, json.size() - 1)), EdidException);
+  EXPECT_THROW(read_edid_json(json + "}"), EdidException);
+  EXPECT_THROW(read_edid_json(R"({"base_block": {"gamma": 256}})"), EdidException);
+  EXPECT_THROW(read_edid_json(R"({"base_block": {"gamma": -1}})"), EdidException);
+  EXPECT_THROW(read_edid_json(R"({"base_block": {"gamma": 2.2}})"), EdidException);
+  EXPECT_THROW(read_edid_json(R"({"base_block": {"bit_depth": "9 bits"}})"), EdidException);
+  EXPECT_THROW(read_edid_json(R"({"base_block": {"chromaticity": [0,0,0,0,0,0,0,0,0,0,0]}})"), EdidException);
+  EXPECT_THROW(read_edid_json(std::string(EDID_JSON_READER_MAX_DEPTH + 1, '[')), EdidException);
+  EXPECT_EQ(read_edid_json(" {} ").base_block, BaseBlock());
+}
+
 TEST(WildEdidParsing, KoganKaled24144F_HDMI) {
   uint8_t edid_binary[] = {
     0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x2c, 0xee, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00,